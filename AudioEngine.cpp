@@ -1,6 +1,64 @@
 #include "AudioEngine.h"
+#include "StageTimer.h"
 #include <juce_dsp/juce_dsp.h>
 
+namespace
+{
+    float getSumOfSquares(const float* samples, int numSamples) noexcept
+    {
+        float sum = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+            sum += samples[i] * samples[i];
+
+        return sum;
+    }
+}
+
+AudioEngine::~AudioEngine()
+{
+    delete pendingDsp.exchange(nullptr);
+    reclaimRetired();
+}
+
+AudioEngine::DspState::DspState(double sampleRate, int blockSize, const PresetSettings& settings)
+    : workBuffer(1, blockSize),
+      sampleRate(sampleRate)
+{
+    chain.prepareToPlay(sampleRate, blockSize, workBuffer.getNumChannels());
+    chain.applySettings(settings);
+    loudnessMeter.prepareToPlay(sampleRate, workBuffer.getNumChannels());
+    inputGain.prepare(sampleRate, blockSize, 0.02);
+    inputGain.setCurrentAndTargetValue(settings.getInputGain());
+}
+
+void AudioEngine::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    const int blockSize = juce::jmax(64, samplesPerBlock);
+
+    const juce::ScopedLock sl(publishLock);
+    fs = sampleRate;
+    profiler.prepare(fs);
+
+    // States the audio thread has already let go of
+    reclaimRetired();
+
+    // Everything the audio thread needs is allocated here; a state that was
+    // published but never picked up is simply replaced
+    delete pendingDsp.exchange(new DspState(fs, blockSize, settings));
+
+    if (auto* device = virtualDevice.load())
+        device->prepareToPlay(fs, blockSize);
+
+    // Re-derive the current parameters for this sample rate
+    publishSnapshot();
+
+    momentaryLufs.store(LoudnessMeter::silenceLufs);
+    shortTermLufs.store(LoudnessMeter::silenceLufs);
+    integratedLufs.store(LoudnessMeter::silenceLufs);
+    loudnessRange.store(0.0f);
+}
+
 void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* in,
                                                     int numIn,
                                                     float* const* out,
@@ -8,72 +66,154 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* in,
                                                     int numSamples,
                                                     const juce::AudioIODeviceCallbackContext&)
 {
+    const CallbackProfiler::ScopedCallback profile(profiler, numSamples);
+    STAGE_TIMER_SCOPE(callback, numSamples);
+
     if (numOut == 0) return;
 
     for (int ch = 0; ch < numOut; ++ch)
         juce::FloatVectorOperations::clear(out[ch], numSamples);
 
-    if (numIn == 0) return;
+    // Block boundary: swap in a state prepared off this thread, if any
+    if (auto* newDsp = pendingDsp.exchange(nullptr))
+    {
+        retire(dsp.release());
+        dsp.reset(newDsp);
+        latencySamples.store(dsp->chain.getLatencySamples());
+    }
+
+    if (numIn == 0 || dsp == nullptr) return;
 
-    const float inG   = inputGain.load();
-    const float outG  = outputGain.load();
+    auto& chain = dsp->chain;
+    auto& loudnessMeter = dsp->loudnessMeter;
+    auto& workBuffer = dsp->workBuffer;
+    auto& inputGain = dsp->inputGain;
+
+    // Pick up the newest complete parameter set, if any. One derived for the
+    // previous sample rate is skipped whole: prepareToPlay() publishes a
+    // re-derived one right after changing the rate.
+    if (snapshots.update())
+    {
+        const auto& snapshot = snapshots.getReadBuffer();
+
+        if (chain.setParameters(snapshot.chain))
+        {
+            inputGain.setTargetValue(snapshot.inputGain);
+            latencySamples.store(chain.getLatencySamples());
+        }
+    }
 
-    // Noise Gate parameters
-    const float gateThr = juce::Decibels::decibelsToGain(gateThreshold.load());
-    const float gateR   = juce::jmax(1.0f, gateRatio.load());
-    const float gateA   = gateAttack.load() / 1000.0f;  // convert ms to seconds
-    const float gateRel = gateRelease.load() / 1000.0f;  // convert ms to seconds
+    MeterFrame frame;
+    frame.samplePosition = dsp->samplePosition;
+    frame.numSamples = numSamples;
+    frame.sampleRate = static_cast<float>(dsp->sampleRate);
+    dsp->samplePosition += numSamples;
 
-    // Compressor parameters
-    const float thr   = juce::Decibels::decibelsToGain(threshDb.load());
-    const float ceilG = juce::Decibels::decibelsToGain(ceilingDb.load());
-    const float R     = juce::jmax(1.0f, ratio.load());
+    auto* device = virtualDevice.load();
 
-    float pkIn = 0.0f, pkOut = 0.0f, maxGr = 0.0f;
+    auto* x = workBuffer.getWritePointer(0);
+    const int maxChunk = workBuffer.getNumSamples();
 
-    for (int n = 0; n < numSamples; ++n)
+    // Process in work-buffer-sized chunks so a device that delivers more samples
+    // than announced in audioDeviceAboutToStart never forces an allocation.
+    for (int offset = 0; offset < numSamples; offset += maxChunk)
     {
-        float x = in[0][n] * inG;           // mono from first input channel
-        pkIn = juce::jmax(pkIn, std::abs(x));
-
-        // Noise Gate processing
-        const float gateLevel = std::abs(x);
-        gateEnv = 0.99f * gateEnv + 0.01f * gateLevel;
-
-        float gateGain = 1.0f;
-        if (gateEnv < gateThr) {
-            const float under = gateThr / gateEnv;
-            const float underDb = juce::Decibels::gainToDecibels(under);
-            const float gateRedDb = underDb - (underDb / gateR);
-            gateGain = juce::Decibels::decibelsToGain(-gateRedDb);
+        const int n = juce::jmin(maxChunk, numSamples - offset);
+
+        juce::dsp::AudioBlock<float> block(workBuffer.getArrayOfWritePointers(), 1, static_cast<size_t>(n));
+
+        // mono from first input channel
+        {
+            STAGE_TIMER_SCOPE(inputGain, n);
+            juce::FloatVectorOperations::copy(x, in[0] + offset, n);
+            inputGain.applyGain(block);
         }
 
-        x *= gateGain;
+        const auto inRange = juce::FloatVectorOperations::findMinAndMax(x, n);
+        frame.inputPeak = juce::jmax(frame.inputPeak, -inRange.getStart(), inRange.getEnd());
+        frame.inputSumOfSquares += getSumOfSquares(x, n);
 
-        // detector
-        const float level = std::abs(x);
-        env = 0.99f * env + 0.01f * level;
+        chain.processBlock(block);
+        frame.gainReductionDb = juce::jmax(frame.gainReductionDb, chain.getGainReduction());
+        frame.gateReductionDb = juce::jmax(frame.gateReductionDb, chain.getGateReduction());
 
-        float gain = 1.0f;
-        if (env > thr) {
-            const float over   = env / thr;
-            const float overDb = juce::Decibels::gainToDecibels(over);
-            const float redDb  = overDb - (overDb / R);   // reduction amount
-            gain = juce::Decibels::decibelsToGain(-redDb);
-            maxGr = juce::jmax(maxGr, redDb);
+        {
+            STAGE_TIMER_SCOPE(loudnessMeter, n);
+            loudnessMeter.processBlock(block);
         }
 
-        float y = x * gain;
-        y = juce::jlimit(-ceilG, ceilG, y);
-        y *= outG;
-
         for (int ch = 0; ch < numOut; ++ch)
-            out[ch][n] = y;
+            juce::FloatVectorOperations::copy(out[ch] + offset, x, n);
+
+        // Straight from the work buffer into the device ring
+        if (device != nullptr)
+        {
+            STAGE_TIMER_SCOPE(virtualDevice, n);
+            device->processAudioBlock(workBuffer, 0, n);
+        }
+
+        const auto outRange = juce::FloatVectorOperations::findMinAndMax(x, n);
+        frame.outputPeak = juce::jmax(frame.outputPeak, -outRange.getStart(), outRange.getEnd());
+        frame.outputSumOfSquares += getSumOfSquares(x, n);
+    }
+
+    frame.autoGainDb = chain.getAutoGainDb();
+    meterTap.push(frame);
+
+    momentaryLufs.store(loudnessMeter.getMomentaryLoudness());
+    shortTermLufs.store(loudnessMeter.getShortTermLoudness());
+    integratedLufs.store(loudnessMeter.getIntegratedLoudness());
+    loudnessRange.store(loudnessMeter.getLoudnessRange());
+}
+
+int AudioEngine::getVirtualDeviceLatencySamples() const
+{
+    auto* device = virtualDevice.load();
+    return device != nullptr && device->isAvailable() ? getLatencySamples() + device->getLatencySamples() : 0;
+}
+
+void AudioEngine::setParameters(const PresetSettings& newSettings)
+{
+    const juce::ScopedLock sl(publishLock);
+    settings = newSettings;
+    publishSnapshot();
+}
+
+PresetSettings AudioEngine::getParameters() const
+{
+    const juce::ScopedLock sl(publishLock);
+    return settings;
+}
+
+void AudioEngine::publishSnapshot()
+{
+    // Called with publishLock held, so there is only ever one writer
+    auto& snapshot = snapshots.getWriteBuffer();
+    snapshot.inputGain = settings.getInputGain();
+    snapshot.chain = ProcessingChain::Parameters::fromSettings(settings);
+    snapshot.chain.prepare(fs);
+
+    snapshots.publish();
+}
 
-        pkOut = juce::jmax(pkOut, std::abs(y));
+void AudioEngine::retire(DspState* state) noexcept
+{
+    if (state == nullptr)
+        return;
+
+    // Lock-free push; the only pop is reclaimRetired() taking the whole list
+    state->nextRetired = retiredDsp.load();
+    while (!retiredDsp.compare_exchange_weak(state->nextRetired, state))
+    {
     }
+}
 
-    inPeak.store(pkIn);
-    outPeak.store(pkOut);
-    grDb.store(maxGr);
+void AudioEngine::reclaimRetired()
+{
+    for (auto* state = retiredDsp.exchange(nullptr); state != nullptr;)
+    {
+        auto* next = state->nextRetired;
+        delete state;
+        state = next;
+    }
 }
@@ -1,38 +1,51 @@
 #pragma once
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <atomic>
+#include "ProcessingChain.h"
+#include "LoudnessMeter.h"
+#include "PresetSettings.h"
+#include "TripleBuffer.h"
+#include "GainRamp.h"
+#include "CallbackProfiler.h"
+#include "MeterTap.h"
+#include "VirtualAudioDevice.h"
 
-// Minimal realtime engine: input -> noise gate -> gentle comp/limiter -> output.
-// Exposes peak meters and gain reduction for UI.
+// Realtime engine: input gain -> ProcessingChain (gate -> auto gain -> compressor -> limiter -> output gain).
+// Streams per-block peak/RMS and gain reduction frames and exposes output loudness (EBU R128) for UI.
+// Each processed block is also written to an optional VirtualAudioDevice.
 class AudioEngine : public juce::AudioIODeviceCallback
 {
 public:
-    // Parameters (hook up UI later if desired)
-    std::atomic<float> inputGain { 1.0f };     // linear
-    std::atomic<float> outputGain{ 1.0f };     // linear
-
-    // Noise Gate parameters
-    std::atomic<float> gateThreshold { -60.0f }; // dB
-    std::atomic<float> gateRatio { 10.0f };     // ratio
-    std::atomic<float> gateAttack { 1.0f };     // ms
-    std::atomic<float> gateRelease { 100.0f };  // ms
-
-    // Compressor parameters
-    std::atomic<float> threshDb  { -18.0f };
-    std::atomic<float> ratio     { 3.0f };
-    std::atomic<float> ceilingDb { -1.0f };
-
-    // Meter taps (read by UI timer)
-    std::atomic<float> inPeak  { 0.0f }; // 0..1
-    std::atomic<float> outPeak { 0.0f }; // 0..1
-    std::atomic<float> grDb    { 0.0f }; // positive reduction amount in dB
+    AudioEngine() = default;
+    ~AudioEngine() override;
+
+    // Output loudness taps (LUFS / LU), updated every 100 ms of audio
+    std::atomic<float> momentaryLufs  { LoudnessMeter::silenceLufs };
+    std::atomic<float> shortTermLufs  { LoudnessMeter::silenceLufs };
+    std::atomic<float> integratedLufs { LoudnessMeter::silenceLufs };
+    std::atomic<float> loudnessRange  { 0.0f };
+
+    // Publishes a complete parameter set (message thread). Coefficients are
+    // derived here; the audio thread picks the snapshot up at the start of
+    // its next block with a single buffer swap.
+    void setParameters(const PresetSettings& newSettings);
+    PresetSettings getParameters() const;
+
+    // Virtual device that receives every processed block (nullptr for none).
+    // The device must outlive the engine's registration as a device callback.
+    void setVirtualDevice(VirtualAudioDevice* device) { virtualDevice.store(device); }
+
+    // Prepares for a sample rate and block size. Called from
+    // audioDeviceAboutToStart(), or directly when the engine is driven by
+    // something other than an AudioIODevice (the virtual device's native mode).
+    // Safe while the audio thread is running: the new DSP state is built here
+    // and swapped in at the start of the next block.
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
 
     void audioDeviceAboutToStart(juce::AudioIODevice* dev) override
     {
-        fs = dev ? dev->getCurrentSampleRate() : 48000.0;
-        env = 0.0f;
-        gateEnv = 0.0f;
-        inPeak.store(0); outPeak.store(0); grDb.store(0);
+        prepareToPlay(dev ? dev->getCurrentSampleRate() : 48000.0,
+                      dev ? dev->getCurrentBufferSizeSamples() : 512);
     }
     void audioDeviceStopped() override {}
 
@@ -44,8 +57,64 @@ public:
                                            int numSamples,
                                            const juce::AudioIODeviceCallbackContext& context) override;
 
+    int getLatencySamples() const { return latencySamples.load(); }
+
+    // Callback timing against the device deadline (switchable at runtime)
+    CallbackProfiler& getProfiler() { return profiler; }
+
+    // One MeterFrame per callback, drained by the UI timer
+    MeterTap& getMeterTap() { return meterTap; }
+
+    // Added latency from the engine input to the virtual device's ports:
+    // processing lookahead plus the device's queued frames and JACK period
+    int getVirtualDeviceLatencySamples() const;
+
 private:
+    // One complete, prepared parameter set
+    struct Snapshot
+    {
+        float inputGain = 1.0f;    // linear
+        ProcessingChain::Parameters chain;
+    };
+
+    // Everything the audio thread processes with, built and prepared as one
+    // unit so that a new sample rate or block size can be swapped in whole
+    struct DspState
+    {
+        DspState(double sampleRate, int blockSize, const PresetSettings& settings);
+
+        ProcessingChain chain;
+        LoudnessMeter loudnessMeter;
+        juce::AudioBuffer<float> workBuffer;      // mono
+        GainRamp inputGain;                       // ramped towards the snapshot value
+        const double sampleRate;
+        juce::int64 samplePosition = 0;           // for the meter frames
+
+        DspState* nextRetired = nullptr;
+    };
+
     double fs = 48000.0;
-    float env = 0.0f; // simple peak follower
-    float gateEnv = 0.0f; // noise gate envelope follower
+
+    // RCU-style handover: prepareToPlay() publishes a new state through
+    // pendingDsp, the audio thread swaps it in at a block boundary and pushes
+    // the replaced one onto the lock-free retired list, which is freed by the
+    // next prepareToPlay() or the destructor.
+    std::unique_ptr<DspState> dsp;                // audio thread only
+    std::atomic<DspState*> pendingDsp { nullptr };
+    std::atomic<DspState*> retiredDsp { nullptr };
+    std::atomic<int> latencySamples { 0 };
+
+    // Publishing side (non-realtime threads only)
+    juce::CriticalSection publishLock;
+    PresetSettings settings;
+    TripleBuffer<Snapshot> snapshots;
+
+    std::atomic<VirtualAudioDevice*> virtualDevice { nullptr };
+
+    CallbackProfiler profiler;
+    MeterTap meterTap;
+
+    void publishSnapshot();
+    void retire(DspState* state) noexcept;
+    void reclaimRetired();
 };
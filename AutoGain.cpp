@@ -0,0 +1,78 @@
+#include "AutoGain.h"
+
+//==============================================================================
+AutoGain::AutoGain()
+{
+}
+
+AutoGain::~AutoGain()
+{
+    releaseResources();
+}
+
+void AutoGain::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    this->sampleRate = sampleRate;
+
+    loudnessMeter.prepareToPlay(sampleRate, numChannels);
+
+    currentGainDb = 0.0f;
+    gainRamp.prepare(sampleRate, samplesPerBlock, 0.05); // 50ms ramps
+    gainRamp.setCurrentAndTargetValue(1.0f);
+}
+
+float AutoGain::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
+{
+    const int numSamples = static_cast<int>(audioBlock.getNumSamples());
+
+    // Open loop: measure the input, not the result
+    loudnessMeter.processBlock(audioBlock);
+
+    const float shortTerm = loudnessMeter.getShortTermLoudness();
+    const float momentary = loudnessMeter.getMomentaryLoudness();
+    const float targetLoudness = parameters.targetLoudness;
+    const float maxBoost = parameters.maxBoost;
+    const float silenceGate = juce::jmax(-70.0f, targetLoudness - silenceGateBelowTarget);
+
+    // Short-term reads silence for the first 3 s; hold the gain until then
+    if (shortTerm > LoudnessMeter::silenceLufs && momentary >= silenceGate)
+    {
+        const float wantedGainDb = juce::jlimit(-maxCutDb, maxBoost, targetLoudness - shortTerm);
+        const float timeSeconds = wantedGainDb < currentGainDb ? cutTimeSeconds : boostTimeSeconds;
+        const float coeff = 1.0f - std::exp(-static_cast<float>(numSamples) / (timeSeconds * static_cast<float>(sampleRate)));
+
+        currentGainDb += (wantedGainDb - currentGainDb) * coeff;
+    }
+
+    // A lowered max boost takes effect immediately
+    currentGainDb = juce::jmin(currentGainDb, maxBoost);
+
+    gainRamp.setTargetValue(juce::Decibels::decibelsToGain(currentGainDb));
+    gainRamp.applyGain(audioBlock);
+
+    return currentGainDb;
+}
+
+void AutoGain::releaseResources()
+{
+    loudnessMeter.releaseResources();
+}
+
+//==============================================================================
+void AutoGain::Parameters::prepare(double)
+{
+    targetLoudness = juce::jlimit(-40.0f, -6.0f, targetLoudness);
+    maxBoost = juce::jlimit(0.0f, 30.0f, maxBoost);
+}
+
+void AutoGain::setTargetLoudness(float lufs)
+{
+    parameters.targetLoudness = lufs;
+    parameters.prepare(sampleRate);
+}
+
+void AutoGain::setMaxBoost(float boostDb)
+{
+    parameters.maxBoost = boostDb;
+    parameters.prepare(sampleRate);
+}
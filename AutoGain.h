@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LoudnessMeter.h"
+#include "GainRamp.h"
+
+//==============================================================================
+// Slow loudness-targeting automatic gain (AGC).
+//
+// Measures the short-term (3 s) loudness of its input and moves a single gain,
+// linked across channels, towards targetLoudness - shortTermLoudness. The
+// move is a one-pole step, so big errors are corrected faster than small
+// ones; cuts settle faster than boosts. Boost is limited to maxBoost. While
+// the momentary loudness sits below the silence gate the gain is frozen,
+// so pauses and room tone are not pulled up. The gain is ramped per sample.
+class AutoGain
+{
+public:
+    AutoGain();
+    ~AutoGain();
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
+    float processBlock(juce::dsp::AudioBlock<float>& audioBlock);
+    void releaseResources();
+
+    // Complete parameter set; prepare() clamps it to the supported ranges
+    struct Parameters
+    {
+        float targetLoudness = -16.0f;   // LUFS
+        float maxBoost = 12.0f;          // dB
+
+        void prepare(double sampleRate);
+    };
+
+    void setParameters(const Parameters& newParameters) { parameters = newParameters; }
+    const Parameters& getParameters() const { return parameters; }
+
+    // Single-parameter setters
+    void setTargetLoudness(float lufs);
+    void setMaxBoost(float boostDb);
+
+    // Currently applied gain in dB (positive = boost)
+    float getGainDb() const { return currentGainDb; }
+
+private:
+    Parameters parameters;
+
+    static constexpr float maxCutDb = 24.0f;
+    static constexpr float silenceGateBelowTarget = 30.0f;   // LU
+    static constexpr float boostTimeSeconds = 4.0f;
+    static constexpr float cutTimeSeconds = 1.0f;
+
+    // Processing state
+    double sampleRate = 44100.0;
+
+    LoudnessMeter loudnessMeter;
+    float currentGainDb = 0.0f;
+    GainRamp gainRamp { GainRamp::Shape::exponential };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoGain)
+};
@@ -0,0 +1,132 @@
+#include "BatchRenderer.h"
+
+//==============================================================================
+class BatchRenderer::Worker : public juce::Thread
+{
+public:
+    Worker(BatchRenderer& ownerToUse, int indexToUse, const PresetSettings& settings, int blockSize)
+        : juce::Thread("Batch render " + juce::String(indexToUse + 1)),
+          owner(ownerToUse),
+          index(indexToUse),
+          renderer(blockSize)
+    {
+        renderer.setSettings(settings);
+    }
+
+    ~Worker() override
+    {
+        stopThread(-1);
+    }
+
+    void run() override
+    {
+        int jobIndex = 0;
+
+        while (!threadShouldExit()
+               && (owner.popOwnJob(index, jobIndex) || owner.stealJob(index, jobIndex)))
+        {
+            const auto& job = (*owner.currentJobs)[static_cast<size_t>(jobIndex)];
+            auto& slot = owner.results[static_cast<size_t>(jobIndex)];
+
+            // Each result slot is only ever written by the worker that took the job
+            slot.result = renderer.renderFile(job.inputFile, job.outputFile, slot.stats);
+        }
+    }
+
+private:
+    BatchRenderer& owner;
+    const int index;
+    OfflineRenderer renderer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer(const PresetSettings& settings, int numWorkers, int blockSize)
+{
+    if (numWorkers <= 0)
+        numWorkers = juce::SystemStats::getNumCpus();
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        queues.push_back(std::make_unique<WorkQueue>());
+        workers.push_back(std::make_unique<Worker>(*this, i, settings, blockSize));
+    }
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    workers.clear();
+}
+
+BatchRenderer::Summary BatchRenderer::run(const std::vector<Job>& jobs)
+{
+    currentJobs = &jobs;
+    results.assign(jobs.size(), JobResult());
+
+    // Deal the jobs out round-robin; stealing evens out the rest
+    for (size_t i = 0; i < jobs.size(); ++i)
+        queues[i % queues.size()]->jobIndices.push_back(static_cast<int>(i));
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    Summary summary;
+    summary.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    for (const auto& jobResult : results)
+    {
+        if (jobResult.result.wasOk())
+        {
+            ++summary.numSucceeded;
+            summary.audioSeconds += jobResult.stats.audioSeconds;
+        }
+        else
+        {
+            ++summary.numFailed;
+        }
+    }
+
+    currentJobs = nullptr;
+    return summary;
+}
+
+//==============================================================================
+bool BatchRenderer::popOwnJob(int workerIndex, int& jobIndex)
+{
+    auto& queue = *queues[static_cast<size_t>(workerIndex)];
+    const juce::SpinLock::ScopedLockType sl(queue.lock);
+
+    if (queue.jobIndices.empty())
+        return false;
+
+    jobIndex = queue.jobIndices.back();
+    queue.jobIndices.pop_back();
+    return true;
+}
+
+bool BatchRenderer::stealJob(int thiefIndex, int& jobIndex)
+{
+    const int numQueues = static_cast<int>(queues.size());
+
+    // Start with the next worker along so thieves spread over different victims
+    for (int offset = 1; offset < numQueues; ++offset)
+    {
+        auto& queue = *queues[static_cast<size_t>((thiefIndex + offset) % numQueues)];
+        const juce::SpinLock::ScopedLockType sl(queue.lock);
+
+        if (!queue.jobIndices.empty())
+        {
+            jobIndex = queue.jobIndices.front();
+            queue.jobIndices.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "OfflineRenderer.h"
+
+//==============================================================================
+// Renders many files in parallel. Each worker thread owns an OfflineRenderer
+// (its own prepared ProcessingChain, format manager and block buffer) that
+// is reused for every file it picks up.
+//
+// Scheduling is work stealing: jobs are dealt round-robin into per-worker
+// deques up front; a worker pops from the back of its own deque and, once
+// that is empty, steals from the front of the others. Long files therefore
+// do not leave the remaining workers idle at the end of a batch.
+class BatchRenderer
+{
+public:
+    struct Job
+    {
+        juce::File inputFile;
+        juce::File outputFile;
+    };
+
+    struct JobResult
+    {
+        juce::Result result { juce::Result::ok() };
+        OfflineRenderer::Stats stats;
+    };
+
+    struct Summary
+    {
+        int numSucceeded = 0;
+        int numFailed = 0;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+
+        // Audio-seconds rendered per wall-clock second across all workers
+        double getThroughput() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+    };
+
+    // numWorkers <= 0 uses one worker per CPU core
+    BatchRenderer(const PresetSettings& settings, int numWorkers = 0,
+                  int blockSize = OfflineRenderer::defaultBlockSize);
+    ~BatchRenderer();
+
+    // Blocks until every job has been rendered. Results line up with jobs.
+    Summary run(const std::vector<Job>& jobs);
+
+    const std::vector<JobResult>& getResults() const { return results; }
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+private:
+    class Worker;
+
+    struct WorkQueue
+    {
+        juce::SpinLock lock;
+        std::deque<int> jobIndices;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    const std::vector<Job>* currentJobs = nullptr;
+    std::vector<JobResult> results;
+
+    bool popOwnJob(int workerIndex, int& jobIndex);
+    bool stealJob(int thiefIndex, int& jobIndex);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchRenderer)
+};
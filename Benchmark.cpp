@@ -0,0 +1,503 @@
+#include <JuceHeader.h>
+#include "AudioEngine.h"
+#include "Compressor.h"
+#include "Limiter.h"
+#include "PresetSettings.h"
+#include "StageTimer.h"
+#include <algorithm>
+#include <iostream>
+
+//==============================================================================
+// Offline DSP microbenchmarks. Configure with -DAUDIOPROCESSOR_BUILD_BENCHMARKS=ON
+// and run the AudioProcessorBenchmark executable.
+//
+// Drives Compressor, Limiter and the full AudioEngine callback with synthetic
+// signals across block sizes, sample rates and channel counts, and writes the
+// results as JSON so that builds can be compared with a script.
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: AudioProcessorBenchmark [--quick] [--processor compressor,limiter,engine]\n"
+                  << "                               [--seconds <s>] [--repetitions <n>] [--label <text>]\n"
+                  << "                               [--output <file.json>] [--trace <file.json>]\n"
+                  << "  Times each case over <s> seconds of audio (default 0.5), <n> times (default 3),\n"
+                  << "  and reports the median. --quick runs a reduced grid. JSON goes to stdout\n"
+                  << "  unless --output is given; progress goes to stderr.\n"
+                  << "  Builds configured with AUDIOPROCESSOR_STAGE_TIMING also report per-stage\n"
+                  << "  ns/sample, and --trace writes the last callbacks as a Chrome trace.\n";
+    }
+
+    //==============================================================================
+    enum class Signal
+    {
+        sine,
+        pinkNoise,
+        speechBursts
+    };
+
+    const char* getSignalName(Signal signal)
+    {
+        switch (signal)
+        {
+            case Signal::sine:          return "sine";
+            case Signal::pinkNoise:     return "pink_noise";
+            case Signal::speechBursts:  return "speech_bursts";
+        }
+
+        return "";
+    }
+
+    // Paul Kellet's economy pink noise filter, about -20 dBFS RMS
+    struct PinkNoise
+    {
+        float next(juce::Random& random)
+        {
+            const float white = random.nextFloat() * 2.0f - 1.0f;
+            b0 = 0.99765f * b0 + white * 0.0990460f;
+            b1 = 0.96300f * b1 + white * 0.2965164f;
+            b2 = 0.57000f * b2 + white * 1.0526913f;
+            return 0.1f * (b0 + b1 + b2 + white * 0.1848f);
+        }
+
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+    };
+
+    // Fills every channel with its own take of the signal (sine phases and
+    // noise seeds differ per channel)
+    void fillSignal(juce::AudioBuffer<float>& buffer, Signal signal, double sampleRate)
+    {
+        const int numSamples = buffer.getNumSamples();
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            float* data = buffer.getWritePointer(channel);
+            juce::Random random(1234 + channel);
+            PinkNoise pink;
+
+            if (signal == Signal::sine)
+            {
+                // 997 Hz at -6 dBFS: loud enough that both dynamics stages work
+                const double increment = juce::MathConstants<double>::twoPi * 997.0 / sampleRate;
+                const double phase = channel * 0.5;
+
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = 0.5f * static_cast<float>(std::sin(phase + increment * i));
+            }
+            else if (signal == Signal::pinkNoise)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = pink.next(random);
+            }
+            else
+            {
+                // Syllables of 80-300 ms with short gaps, a longer pause every few
+                // syllables; the carrier is a voiced buzz around 140 Hz plus breath noise
+                int i = 0;
+                double voicePhase = 0.0;
+
+                while (i < numSamples)
+                {
+                    const int syllables = 2 + random.nextInt(5);
+
+                    for (int s = 0; s < syllables && i < numSamples; ++s)
+                    {
+                        const int length = static_cast<int>(sampleRate * (0.08 + 0.22 * random.nextDouble()));
+                        const int gap = static_cast<int>(sampleRate * (0.03 + 0.09 * random.nextDouble()));
+                        const float level = 0.2f + 0.7f * random.nextFloat();
+                        const double pitch = 110.0 + 60.0 * random.nextDouble();
+
+                        for (int n = 0; n < length && i < numSamples; ++n, ++i)
+                        {
+                            const double envelope = std::sin(juce::MathConstants<double>::pi * n / length);
+                            voicePhase += juce::MathConstants<double>::twoPi * pitch / sampleRate;
+
+                            double voiced = 0.0;
+                            for (int harmonic = 1; harmonic <= 6; ++harmonic)
+                                voiced += std::sin(voicePhase * harmonic) / harmonic;
+
+                            data[i] = level * static_cast<float>(envelope * envelope * (0.5 * voiced))
+                                    + level * pink.next(random);
+                        }
+
+                        for (int n = 0; n < gap && i < numSamples; ++n, ++i)
+                            data[i] = 0.01f * pink.next(random);
+                    }
+
+                    const int pause = static_cast<int>(sampleRate * (0.3 + 0.4 * random.nextDouble()));
+                    for (int n = 0; n < pause && i < numSamples; ++n, ++i)
+                        data[i] = 0.01f * pink.next(random);
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    struct Options
+    {
+        double seconds = 0.5;
+        int repetitions = 3;
+        juce::StringArray processors { "compressor", "limiter", "engine" };
+        std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        std::vector<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        std::vector<int> channelCounts { 1, 2, 4, 8, 16 };
+        std::vector<Signal> signals { Signal::sine, Signal::pinkNoise, Signal::speechBursts };
+    };
+
+    struct Measurement
+    {
+        double nsPerSample = 0.0;           // per processed channel sample, median of the repetitions
+        double nsPerSampleBest = 0.0;       // fastest repetition
+        double realtimeFactor = 0.0;        // audio time / processing time
+        double headroomPercent = 0.0;       // share of the realtime budget left on average
+        double worstBlockLoadPercent = 0.0; // slowest single block against its duration
+        int processedChannels = 0;          // channels the DSP runs on (the engine is mono)
+    };
+
+    // Copies the looping source into a block-sized buffer and times only
+    // process(buffer). The first second of audio is a warm-up and not timed.
+    // Cost per sample is divided over processedChannels, which is numChannels
+    // unless the processor mixes down first.
+    template <typename ProcessFunction>
+    Measurement measure(const juce::AudioBuffer<float>& source, double sampleRate, int blockSize,
+                        int numChannels, const Options& options, ProcessFunction&& process,
+                        int processedChannels = -1)
+    {
+        if (processedChannels < 0)
+            processedChannels = numChannels;
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        int sourcePosition = 0;
+
+        auto nextBlock = [&]
+        {
+            for (int done = 0; done < blockSize;)
+            {
+                const int count = juce::jmin(blockSize - done, source.getNumSamples() - sourcePosition);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    buffer.copyFrom(channel, done, source, channel, sourcePosition, count);
+
+                done += count;
+                sourcePosition = (sourcePosition + count) % source.getNumSamples();
+            }
+        };
+
+        const int blocksPerRun = juce::jmax(1, juce::roundToInt(options.seconds * sampleRate / blockSize));
+        const int warmupBlocks = juce::jmax(1, juce::roundToInt(sampleRate / blockSize));
+
+        for (int block = 0; block < warmupBlocks; ++block)
+        {
+            nextBlock();
+            process(buffer);
+        }
+
+        std::vector<double> runSeconds;
+        juce::int64 worstBlockTicks = 0;
+
+        for (int run = 0; run < options.repetitions; ++run)
+        {
+            juce::int64 ticks = 0;
+
+            for (int block = 0; block < blocksPerRun; ++block)
+            {
+                nextBlock();
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                process(buffer);
+                const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+                ticks += elapsed;
+                worstBlockTicks = juce::jmax(worstBlockTicks, elapsed);
+            }
+
+            runSeconds.push_back(juce::Time::highResolutionTicksToSeconds(ticks));
+        }
+
+        std::sort(runSeconds.begin(), runSeconds.end());
+
+        const double medianSeconds = runSeconds[runSeconds.size() / 2];
+        const double audioSeconds = static_cast<double>(blocksPerRun) * blockSize / sampleRate;
+        const double samplesPerRun = static_cast<double>(blocksPerRun) * blockSize * processedChannels;
+
+        Measurement measurement;
+        measurement.nsPerSample = medianSeconds * 1.0e9 / samplesPerRun;
+        measurement.nsPerSampleBest = runSeconds.front() * 1.0e9 / samplesPerRun;
+        measurement.realtimeFactor = medianSeconds > 0.0 ? audioSeconds / medianSeconds : 0.0;
+        measurement.headroomPercent = 100.0 * (1.0 - medianSeconds / audioSeconds);
+        measurement.worstBlockLoadPercent = 100.0 * juce::Time::highResolutionTicksToSeconds(worstBlockTicks)
+                                                  / (blockSize / sampleRate);
+        measurement.processedChannels = processedChannels;
+        return measurement;
+    }
+
+    Measurement runCase(const juce::String& processor, const juce::AudioBuffer<float>& source,
+                        double sampleRate, int blockSize, int numChannels, const Options& options)
+    {
+        if (processor == "compressor")
+        {
+            Compressor compressor;
+            compressor.setThreshold(-24.0f);
+            compressor.setRatio(4.0f);
+            compressor.setAttack(5.0f);
+            compressor.setRelease(50.0f);
+            compressor.prepareToPlay(sampleRate, blockSize);
+
+            return measure(source, sampleRate, blockSize, numChannels, options, [&](juce::AudioBuffer<float>& buffer)
+            {
+                juce::dsp::AudioBlock<float> block(buffer);
+                compressor.processBlock(block);
+            });
+        }
+
+        if (processor == "limiter")
+        {
+            Limiter limiter;
+            limiter.setCeiling(-1.0f);
+            limiter.setLookahead(5.0f);
+            limiter.prepareToPlay(sampleRate, blockSize, numChannels);
+
+            return measure(source, sampleRate, blockSize, numChannels, options, [&](juce::AudioBuffer<float>& buffer)
+            {
+                juce::dsp::AudioBlock<float> block(buffer);
+                limiter.processBlock(block);
+            });
+        }
+
+        // The whole device callback with default settings, as the app runs it.
+        // The engine processes the first input channel only, so its cost is
+        // per frame whatever the channel count.
+        AudioEngine engine;
+        engine.setParameters(PresetSettings());
+        engine.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output(numChannels, blockSize);
+
+        return measure(source, sampleRate, blockSize, numChannels, options, [&](juce::AudioBuffer<float>& buffer)
+        {
+            engine.audioDeviceIOCallbackWithContext(buffer.getArrayOfReadPointers(), numChannels,
+                                                    output.getArrayOfWritePointers(), numChannels,
+                                                    blockSize, {});
+        }, 1);
+    }
+
+    //==============================================================================
+    // Limiter cost per sample across lookahead lengths. The peak hold is a
+    // sliding-window minimum, so the figures should stay flat as lookahead grows.
+    juce::var benchmarkLimiterLookahead(const juce::AudioBuffer<float>& source, const Options& options)
+    {
+        constexpr double sampleRate = 96000.0;
+        constexpr int blockSize = 512;
+        constexpr int numChannels = 2;
+
+        juce::Array<juce::var> results;
+
+        for (float lookaheadMs : { 0.5f, 1.0f, 2.5f, 5.0f, 10.0f })
+        {
+            Limiter limiter;
+            limiter.setCeiling(-1.0f);
+            limiter.setLookahead(lookaheadMs);
+            limiter.prepareToPlay(sampleRate, blockSize, numChannels);
+
+            const auto measurement = measure(source, sampleRate, blockSize, numChannels, options,
+                                             [&](juce::AudioBuffer<float>& buffer)
+            {
+                juce::dsp::AudioBlock<float> block(buffer);
+                limiter.processBlock(block);
+            });
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("lookaheadMs", lookaheadMs);
+            entry->setProperty("lookaheadSamples", limiter.getLatencySamples());
+            entry->setProperty("nsPerSample", measurement.nsPerSample);
+            results.add(juce::var(entry));
+        }
+
+        return results;
+    }
+
+    // Per-stage cost over one case; stages run on the mono work buffer, so
+    // these are per frame rather than per channel sample
+    juce::var describeStages(const StageTimer::Snapshot& stages)
+    {
+        auto* entry = new juce::DynamicObject();
+
+        for (int stage = 0; stage < StageTimer::numStages; ++stage)
+            if (stages[static_cast<size_t>(stage)].calls > 0)
+                entry->setProperty(StageTimer::getStageName(stage), stages[static_cast<size_t>(stage)].getNanosecondsPerSample());
+
+        return entry;
+    }
+
+    juce::var describeBuild(const juce::String& label)
+    {
+        auto* build = new juce::DynamicObject();
+        build->setProperty("label", label);
+        build->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        build->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+        build->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        build->setProperty("cpu", juce::SystemStats::getCpuModel());
+        build->setProperty("cpuCores", juce::SystemStats::getNumCpus());
+
+       #if defined (__clang__)
+        build->setProperty("compiler", "clang " __clang_version__);
+       #elif defined (__GNUC__)
+        build->setProperty("compiler", "gcc " __VERSION__);
+       #elif defined (_MSC_VER)
+        build->setProperty("compiler", "msvc " + juce::String(_MSC_FULL_VER));
+       #endif
+
+       #if JUCE_DEBUG
+        build->setProperty("buildType", "Debug");
+       #else
+        build->setProperty("buildType", "Release");
+       #endif
+
+        return build;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+
+    if (args.removeOptionIfFound("--quick"))
+    {
+        options.blockSizes = { 64, 512, 4096 };
+        options.sampleRates = { 48000.0 };
+        options.channelCounts = { 1, 2 };
+    }
+
+    const auto processorText = args.removeValueForOption("--processor");
+    const auto secondsText = args.removeValueForOption("--seconds");
+    const auto repetitionsText = args.removeValueForOption("--repetitions");
+    const auto label = args.removeValueForOption("--label");
+    const auto outputPath = args.removeValueForOption("--output|-o");
+    const auto tracePath = args.removeValueForOption("--trace");
+
+    if (processorText.isNotEmpty())
+        options.processors = juce::StringArray::fromTokens(processorText, ",", "");
+
+    if (secondsText.isNotEmpty())
+        options.seconds = juce::jmax(0.01, secondsText.getDoubleValue());
+
+    if (repetitionsText.isNotEmpty())
+        options.repetitions = juce::jmax(1, repetitionsText.getIntValue());
+
+    for (const auto& processor : options.processors)
+    {
+        if (processor != "compressor" && processor != "limiter" && processor != "engine")
+        {
+            std::cerr << "Unknown processor: " << processor << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    const int maxChannels = *std::max_element(options.channelCounts.begin(), options.channelCounts.end());
+    juce::Array<juce::var> results;
+
+    for (const double sampleRate : options.sampleRates)
+    {
+        for (const auto signal : options.signals)
+        {
+            // One second of each signal, looped
+            juce::AudioBuffer<float> source(maxChannels, static_cast<int>(sampleRate));
+            fillSignal(source, signal, sampleRate);
+
+            for (const auto& processor : options.processors)
+            {
+                for (const int numChannels : options.channelCounts)
+                {
+                    for (const int blockSize : options.blockSizes)
+                    {
+                        std::cerr << processor << " " << getSignalName(signal) << " " << sampleRate << " Hz "
+                                  << blockSize << " samples " << numChannels << " ch\n";
+
+                        const auto stagesBefore = StageTimer::getSnapshot();
+                        const auto measurement = runCase(processor, source, sampleRate, blockSize, numChannels, options);
+                        const auto stages = StageTimer::getDifference(StageTimer::getSnapshot(), stagesBefore);
+
+                        auto* entry = new juce::DynamicObject();
+                        entry->setProperty("processor", processor);
+                        entry->setProperty("signal", getSignalName(signal));
+                        entry->setProperty("sampleRate", sampleRate);
+                        entry->setProperty("blockSize", blockSize);
+                        entry->setProperty("channels", numChannels);
+                        entry->setProperty("processedChannels", measurement.processedChannels);
+                        entry->setProperty("nsPerSample", measurement.nsPerSample);
+                        entry->setProperty("nsPerSampleBest", measurement.nsPerSampleBest);
+                        entry->setProperty("realtimeFactor", measurement.realtimeFactor);
+                        entry->setProperty("headroomPercent", measurement.headroomPercent);
+                        entry->setProperty("worstBlockLoadPercent", measurement.worstBlockLoadPercent);
+
+                        if (StageTimer::isCompiledIn())
+                            entry->setProperty("stagesNsPerFrame", describeStages(stages));
+
+                        results.add(juce::var(entry));
+                    }
+                }
+            }
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("build", describeBuild(label));
+
+    auto* config = new juce::DynamicObject();
+    config->setProperty("secondsPerRun", options.seconds);
+    config->setProperty("repetitions", options.repetitions);
+    report->setProperty("config", juce::var(config));
+
+    report->setProperty("results", results);
+
+    if (options.processors.contains("limiter"))
+    {
+        juce::AudioBuffer<float> noise(2, 96000);
+        fillSignal(noise, Signal::pinkNoise, 96000.0);
+        report->setProperty("limiterLookahead", benchmarkLimiterLookahead(noise, options));
+    }
+
+    if (tracePath.isNotEmpty())
+    {
+        const auto traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(tracePath.unquoted());
+        const auto result = StageTimer::writeChromeTrace(traceFile, 100);
+
+        if (result.failed())
+        {
+            std::cerr << result.getErrorMessage() << "\n";
+            return 1;
+        }
+
+        std::cerr << "Wrote stage trace to " << traceFile.getFullPathName() << "\n";
+    }
+
+    const auto json = juce::JSON::toString(juce::var(report), false, 3);
+
+    if (outputPath.isNotEmpty())
+    {
+        const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath.unquoted());
+
+        if (!outputFile.replaceWithText(json))
+        {
+            std::cerr << "Cannot write " << outputFile.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::cerr << "Wrote " << results.size() << " results to " << outputFile.getFullPathName() << "\n";
+    }
+    else
+    {
+        std::cout << json << "\n";
+    }
+
+    return 0;
+}
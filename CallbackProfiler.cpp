@@ -0,0 +1,138 @@
+#include "CallbackProfiler.h"
+
+namespace
+{
+    // Single-writer increment: a plain load/store avoids a locked instruction
+    // on the audio thread, and readers only ever see whole values
+    template <typename T>
+    void addTo(std::atomic<T>& counter, T amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+CallbackProfiler::CallbackProfiler()
+    : nanosecondsPerTick(1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()))
+{
+}
+
+void CallbackProfiler::prepare(double sampleRate) noexcept
+{
+    if (sampleRate > 0.0)
+        nanosecondsPerSample.store(1.0e9 / sampleRate, std::memory_order_relaxed);
+}
+
+int CallbackProfiler::getBucket(uint32_t nanoseconds) noexcept
+{
+    constexpr uint32_t subBuckets = 1u << subBucketBits;
+
+    // Below 8 ns each value has its own bucket; above, the top bit picks the
+    // octave and the next three bits the step within it
+    if (nanoseconds < subBuckets)
+        return static_cast<int>(nanoseconds);
+
+    const int octave = juce::findHighestSetBit(nanoseconds);
+    const auto step = (nanoseconds >> (octave - subBucketBits)) & (subBuckets - 1);
+    return ((octave - subBucketBits + 1) << subBucketBits) | static_cast<int>(step);
+}
+
+double CallbackProfiler::getBucketUpperEdgeMicros(int bucket) noexcept
+{
+    constexpr int subBuckets = 1 << subBucketBits;
+
+    if (bucket < subBuckets)
+        return (bucket + 1) * 1.0e-3;
+
+    const int octave = (bucket >> subBucketBits) + subBucketBits - 1;
+    const int step = bucket & (subBuckets - 1);
+    return std::ldexp(static_cast<double>(subBuckets + step + 1), octave - subBucketBits) * 1.0e-3;
+}
+
+void CallbackProfiler::addCallback(juce::int64 ticks, int numSamples) noexcept
+{
+    const auto elapsed = static_cast<uint32_t>(juce::jlimit(0.0, 4.0e9, static_cast<double>(ticks) * nanosecondsPerTick));
+    const auto budget = static_cast<uint32_t>(juce::jlimit(0.0, 4.0e9, numSamples * nanosecondsPerSample.load(std::memory_order_relaxed)));
+
+    addTo(buckets[static_cast<size_t>(getBucket(elapsed))], 1u);
+    addTo(numCallbacks, uint64_t { 1 });
+    addTo(busyNanoseconds, uint64_t { elapsed });
+    addTo(budgetNanoseconds, uint64_t { budget });
+    lastBudgetNanoseconds.store(budget, std::memory_order_relaxed);
+
+    if (elapsed > budget)
+        addTo(overruns, uint64_t { 1 });
+
+    if (elapsed > maxNanoseconds.load(std::memory_order_relaxed))
+        maxNanoseconds.store(elapsed, std::memory_order_relaxed);
+}
+
+//==============================================================================
+CallbackProfiler::Report CallbackProfiler::getReport()
+{
+    Report report;
+
+    std::array<uint32_t, numBuckets> counts;
+    uint64_t bucketTotal = 0;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        const auto count = buckets[i].load(std::memory_order_relaxed);
+        counts[i] = count - lastBuckets[i];    // wraps correctly
+        lastBuckets[i] = count;
+        bucketTotal += counts[i];
+    }
+
+    const auto callbacks = numCallbacks.load(std::memory_order_relaxed);
+    const auto busy = busyNanoseconds.load(std::memory_order_relaxed);
+    const auto budget = budgetNanoseconds.load(std::memory_order_relaxed);
+    const auto overrunsTotal = overruns.load(std::memory_order_relaxed);
+
+    report.numCallbacks = callbacks - lastNumCallbacks;
+    report.overruns = overrunsTotal - lastOverruns;
+    report.totalOverruns = overrunsTotal;
+    report.budgetMicros = lastBudgetNanoseconds.load(std::memory_order_relaxed) * 1.0e-3;
+    report.maxMicros = maxNanoseconds.exchange(0, std::memory_order_relaxed) * 1.0e-3;
+
+    if (budget > lastBudgetNanosecondsTotal)
+        report.loadPercent = 100.0 * static_cast<double>(busy - lastBusyNanoseconds)
+                                   / static_cast<double>(budget - lastBudgetNanosecondsTotal);
+
+    lastNumCallbacks = callbacks;
+    lastBusyNanoseconds = busy;
+    lastBudgetNanosecondsTotal = budget;
+    lastOverruns = overrunsTotal;
+
+    // Percentiles from the interval's histogram
+    const uint64_t p50Rank = (bucketTotal + 1) / 2;
+    const uint64_t p99Rank = bucketTotal - bucketTotal / 100;
+    uint64_t cumulative = 0;
+
+    for (int i = 0; i < numBuckets && bucketTotal > 0; ++i)
+    {
+        const auto previous = cumulative;
+        cumulative += counts[static_cast<size_t>(i)];
+
+        if (previous < p50Rank && cumulative >= p50Rank)
+            report.p50Micros = getBucketUpperEdgeMicros(i);
+
+        if (previous < p99Rank && cumulative >= p99Rank)
+        {
+            report.p99Micros = getBucketUpperEdgeMicros(i);
+            break;
+        }
+    }
+
+    return report;
+}
+
+juce::String CallbackProfiler::Report::toString() const
+{
+    return "load " + juce::String(loadPercent, 1) + "%, "
+         + "p50 " + juce::String(juce::roundToInt(p50Micros)) + " us, "
+         + "p99 " + juce::String(juce::roundToInt(p99Micros)) + " us, "
+         + "max " + juce::String(juce::roundToInt(maxMicros)) + " us "
+         + "(deadline " + juce::String(juce::roundToInt(budgetMicros)) + " us), "
+         + juce::String(static_cast<juce::int64>(overruns)) + " overruns ("
+         + juce::String(static_cast<juce::int64>(totalOverruns)) + " total)";
+}
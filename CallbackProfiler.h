@@ -0,0 +1,105 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+// Load profiler for a realtime audio callback.
+//
+// The audio thread times each callback with a ScopedCallback and files the
+// duration into a fixed, log-spaced histogram (8 buckets per octave, about 9%
+// wide) of atomic counters. It also adds to running busy/budget totals and
+// counts callbacks that overran their deadline, i.e. took longer than the
+// audio they produced. It does no locking and allocates nothing; with
+// profiling switched off a callback costs one relaxed load.
+//
+// A single non-realtime reader calls getReport(), which diffs the counters
+// against its previous call: load, p50/p99/max callback time and overruns
+// over that interval.
+class CallbackProfiler
+{
+public:
+    CallbackProfiler();
+
+    // Deadline per sample; call whenever the sample rate changes (any thread)
+    void prepare(double sampleRate) noexcept;
+
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Times the enclosing audio callback for numSamples samples
+    class ScopedCallback
+    {
+    public:
+        ScopedCallback(CallbackProfiler& profilerToUse, int numSamples) noexcept
+            : profiler(profilerToUse.isEnabled() ? &profilerToUse : nullptr),
+              samples(numSamples),
+              startTicks(profiler != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedCallback() noexcept
+        {
+            if (profiler != nullptr)
+                profiler->addCallback(juce::Time::getHighResolutionTicks() - startTicks, samples);
+        }
+
+    private:
+        CallbackProfiler* profiler;
+        int samples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+    //==============================================================================
+    struct Report
+    {
+        uint64_t numCallbacks = 0;
+        double loadPercent = 0.0;        // time spent in callbacks / audio time they produced
+        double p50Micros = 0.0;          // bucket upper edges, so slightly pessimistic
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+        double budgetMicros = 0.0;       // deadline of the latest callback
+        uint64_t overruns = 0;           // callbacks over their deadline in the interval
+        uint64_t totalOverruns = 0;
+
+        juce::String toString() const;
+    };
+
+    // Statistics since the previous call. Single reader (e.g. the UI timer).
+    Report getReport();
+
+private:
+    static constexpr int subBucketBits = 3;
+    static constexpr int numBuckets = ((31 - 2) << subBucketBits) + (1 << subBucketBits);
+
+    static int getBucket(uint32_t nanoseconds) noexcept;
+    static double getBucketUpperEdgeMicros(int bucket) noexcept;
+
+    void addCallback(juce::int64 ticks, int numSamples) noexcept;
+
+    std::atomic<bool> enabled { true };
+    std::atomic<double> nanosecondsPerSample { 1.0e9 / 48000.0 };
+    const double nanosecondsPerTick;
+
+    // Written by the audio thread only
+    std::array<std::atomic<uint32_t>, numBuckets> buckets {};
+    std::atomic<uint64_t> numCallbacks { 0 };
+    std::atomic<uint64_t> busyNanoseconds { 0 };
+    std::atomic<uint64_t> budgetNanoseconds { 0 };
+    std::atomic<uint64_t> overruns { 0 };
+    std::atomic<uint32_t> lastBudgetNanoseconds { 0 };
+    std::atomic<uint32_t> maxNanoseconds { 0 };         // reset by the reader
+
+    // Reader state
+    std::array<uint32_t, numBuckets> lastBuckets {};
+    uint64_t lastNumCallbacks = 0;
+    uint64_t lastBusyNanoseconds = 0;
+    uint64_t lastBudgetNanosecondsTotal = 0;
+    uint64_t lastOverruns = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CallbackProfiler)
+};
@@ -0,0 +1,224 @@
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include "BatchRenderer.h"
+#include "PresetSettings.h"
+#include <iostream>
+#include <iomanip>
+#include <map>
+
+//==============================================================================
+// Headless front end for render servers: applies a .preset to an audio file
+// with the same ProcessingChain the app uses, no GUI or audio device needed.
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: AudioProcessorCLI --preset <file.preset> [--block-size <samples>] <input> <output>\n"
+                  << "       AudioProcessorCLI --preset <file.preset> --output-dir <dir> [--jobs <n>] [--format <ext>]\n"
+                  << "                         [--block-size <samples>] <input files or directories>...\n"
+                  << "  Reads WAV, FLAC or AIFF; the output format follows the output file extension.\n"
+                  << "  Batch mode renders every input into --output-dir using all cores (or --jobs);\n"
+                  << "  it refuses to start if an output would overwrite an input or another output.\n";
+    }
+
+    juce::File resolvePath(const juce::String& path)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path.unquoted());
+    }
+
+    // Expands directories to the audio files they contain and maps each input
+    // to a file of the same name in the output directory
+    std::vector<BatchRenderer::Job> collectBatchJobs(const juce::ArgumentList& args,
+                                                     const juce::File& outputDirectory,
+                                                     const juce::String& outputExtension)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        const auto wildcard = formatManager.getWildcardForAllFormats();
+
+        juce::Array<juce::File> inputFiles;
+
+        for (const auto& argument : args.arguments)
+        {
+            const auto file = argument.resolveAsFile();
+
+            if (file.isDirectory())
+                inputFiles.addArray(file.findChildFiles(juce::File::findFiles, false, wildcard));
+            else
+                inputFiles.add(file);
+        }
+
+        std::vector<BatchRenderer::Job> jobs;
+        jobs.reserve(static_cast<size_t>(inputFiles.size()));
+
+        for (const auto& inputFile : inputFiles)
+        {
+            auto outputName = inputFile.getFileName();
+            if (outputExtension.isNotEmpty())
+                outputName = inputFile.getFileNameWithoutExtension() + "." + outputExtension.trimCharactersAtStart(".");
+
+            jobs.push_back({ inputFile, outputDirectory.getChildFile(outputName) });
+        }
+
+        return jobs;
+    }
+
+    // An output that would replace an input, or that two inputs map to, would
+    // silently lose a render (or the source); returns one line per clash
+    juce::StringArray findOutputCollisions(const std::vector<BatchRenderer::Job>& jobs)
+    {
+        std::map<juce::File, size_t> inputs, outputs;
+        juce::StringArray collisions;
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+            inputs.emplace(jobs[i].inputFile, i);
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            const auto& outputFile = jobs[i].outputFile;
+
+            if (inputs.count(outputFile) != 0)
+                collisions.add(outputFile.getFullPathName() + " would overwrite an input file");
+
+            const auto [previous, isNew] = outputs.emplace(outputFile, i);
+
+            if (!isNew)
+                collisions.add(outputFile.getFullPathName() + " is the output of both "
+                               + jobs[previous->second].inputFile.getFullPathName() + " and "
+                               + jobs[i].inputFile.getFullPathName());
+        }
+
+        return collisions;
+    }
+
+    // A render at or below the loudness gate almost always means a wrong preset
+    // gain or level, not silent source material
+    bool isSilent(const OfflineRenderer::Stats& stats)
+    {
+        return stats.audioSeconds > 0.0 && stats.integratedLufs <= LoudnessMeter::silenceLufs;
+    }
+
+    int runBatch(juce::ArgumentList& args, const PresetSettings& settings, int blockSize)
+    {
+        const auto outputDirectory = resolvePath(args.removeValueForOption("--output-dir|-o"));
+        const auto jobsText = args.removeValueForOption("--jobs|-j");
+        const auto outputExtension = args.removeValueForOption("--format|-f");
+
+        if (args.size() == 0)
+        {
+            printUsage();
+            return 1;
+        }
+
+        const auto jobs = collectBatchJobs(args, outputDirectory, outputExtension);
+        const auto collisions = findOutputCollisions(jobs);
+
+        if (!collisions.isEmpty())
+        {
+            for (const auto& collision : collisions)
+                std::cerr << collision << "\n";
+
+            std::cerr << "Nothing rendered: rename the clashing inputs, or pick another --output-dir or --format\n";
+            return 1;
+        }
+
+        const auto created = outputDirectory.createDirectory();
+        if (created.failed())
+        {
+            std::cerr << "Cannot create output directory: " << created.getErrorMessage() << "\n";
+            return 1;
+        }
+
+        BatchRenderer batch(settings, jobsText.getIntValue(), blockSize);
+
+        std::cout << "Rendering " << jobs.size() << " files on " << batch.getNumWorkers() << " workers\n";
+
+        const auto summary = batch.run(jobs);
+        const auto& results = batch.getResults();
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            if (results[i].result.failed())
+                std::cerr << jobs[i].inputFile.getFullPathName() << ": " << results[i].result.getErrorMessage() << "\n";
+            else if (isSilent(results[i].stats))
+                std::cerr << "Warning: " << jobs[i].outputFile.getFullPathName() << " is silent\n";
+        }
+
+        std::cout << summary.numSucceeded << " rendered, " << summary.numFailed << " failed\n"
+                  << std::fixed << std::setprecision(2)
+                  << summary.audioSeconds << " s of audio in " << summary.wallSeconds << " s ("
+                  << summary.getThroughput() << " audio-seconds per second)\n";
+
+        return summary.numFailed == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    const auto presetPath = args.removeValueForOption("--preset|-p");
+    const auto blockSizeText = args.removeValueForOption("--block-size|-b");
+
+    const bool batchMode = args.containsOption("--output-dir|-o");
+
+    if (presetPath.isEmpty() || (!batchMode && args.size() != 2))
+    {
+        printUsage();
+        return 1;
+    }
+
+    PresetSettings settings;
+    if (!settings.loadFromFile(resolvePath(presetPath)))
+    {
+        std::cerr << "Could not load preset: " << presetPath << "\n";
+        return 1;
+    }
+
+    const int blockSize = blockSizeText.isNotEmpty() ? blockSizeText.getIntValue()
+                                                     : OfflineRenderer::defaultBlockSize;
+
+    if (batchMode)
+        return runBatch(args, settings, blockSize);
+
+    OfflineRenderer renderer(blockSize);
+    renderer.setSettings(settings);
+
+    const auto inputFile = args[0].resolveAsFile();
+    const auto outputFile = args[1].resolveAsFile();
+
+    if (outputFile == inputFile)
+    {
+        std::cerr << "The output would overwrite the input: " << inputFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    OfflineRenderer::Stats stats;
+    const auto result = renderer.renderFile(inputFile, outputFile, stats);
+
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << "\n";
+        return 1;
+    }
+
+    std::cout << "Rendered " << outputFile.getFullPathName()
+              << " with preset '" << (settings.name.isNotEmpty() ? settings.name : presetPath) << "'\n"
+              << std::fixed << std::setprecision(2)
+              << stats.audioSeconds << " s of audio in " << stats.wallSeconds << " s ("
+              << stats.getRealtimeFactor() << "x realtime)\n"
+              << std::setprecision(1)
+              << "Output loudness " << stats.integratedLufs << " LUFS integrated, "
+              << stats.loudnessRange << " LU range\n";
+
+    if (isSilent(stats))
+        std::cerr << "Warning: the output is silent, check the preset's gain settings\n";
+
+    return 0;
+}
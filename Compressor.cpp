@@ -1,9 +1,9 @@
 #include "Compressor.h"
+#include "StageTimer.h"
 
 //==============================================================================
 Compressor::Compressor()
 {
-    gainReductionSmoothed.setCurrentAndTargetValue(0.0f);
 }
 
 Compressor::~Compressor()
@@ -21,20 +21,28 @@ void Compressor::prepareToPlay(double sampleRate, int samplesPerBlock)
     rmsBuffer.clear();
     rmsIndex = 0;
     
-    // Setup smoothed values
-    gainReductionSmoothed.reset(sampleRate, 0.01); // 10ms smoothing
+    // Start from rest, so a reused compressor renders like a new one
+    envelope = 0.0f;
+    currentGainReduction = 0.0f;
     
-    // Update coefficients
-    updateCoefficients();
+    // Setup gain ramp
+    gainRamp.prepare(sampleRate, samplesPerBlock, 0.01); // 10ms ramps
+    gainRampPrimed = false;
+    
+    // Derive coefficients for the new sample rate
+    parameters.prepare(sampleRate);
 }
 
 float Compressor::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
 {
-    const int numChannels = static_cast<int>(audioBlock.getNumChannels());
-    const int numSamples = static_cast<int>(audioBlock.getNumSamples());
-    
     // Get RMS level of input
-    float rmsLevel = getRMSLevel(audioBlock);
+    float rmsLevel;
+    {
+        STAGE_TIMER_SCOPE(compressorDetector, static_cast<int>(audioBlock.getNumSamples()));
+        rmsLevel = getRMSLevel(audioBlock);
+    }
+    
+    STAGE_TIMER_SCOPE(compressorGain, static_cast<int>(audioBlock.getNumSamples()));
     
     // Convert to dB
     float rmsLevelDb = rmsLevel > 0.0f ? juce::Decibels::gainToDecibels(rmsLevel) : -100.0f;
@@ -42,34 +50,33 @@ float Compressor::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
     // Calculate required gain reduction
     float targetGainReduction = calculateGainReduction(rmsLevelDb);
     
-    // Apply envelope follower
+    // Apply envelope follower. The coefficients are per sample but the
+    // envelope steps once per block, so raise them to the block length:
+    // attack and release then take as long at any device buffer size.
+    const auto blockLength = static_cast<float>(audioBlock.getNumSamples());
+
     if (targetGainReduction > envelope)
     {
         // Attack phase
-        envelope = targetGainReduction + (envelope - targetGainReduction) * attackCoeff;
+        envelope = targetGainReduction + (envelope - targetGainReduction) * std::pow(parameters.attackCoeff, blockLength);
     }
     else
     {
         // Release phase
-        envelope = targetGainReduction + (envelope - targetGainReduction) * releaseCoeff;
+        envelope = targetGainReduction + (envelope - targetGainReduction) * std::pow(parameters.releaseCoeff, blockLength);
     }
     
-    // Smooth the gain reduction for audio application
-    gainReductionSmoothed.setTargetValue(envelope);
-    
-    // Apply gain reduction to audio
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Start from the makeup gain alone, as the envelope does from zero
+    if (!gainRampPrimed)
     {
-        float gainReduction = gainReductionSmoothed.getNextValue();
-        float gain = juce::Decibels::decibelsToGain(-gainReduction + makeupGain);
-        
-        for (int channel = 0; channel < numChannels; ++channel)
-        {
-            auto* channelData = audioBlock.getChannelPointer(channel);
-            channelData[sample] *= gain;
-        }
+        gainRamp.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(parameters.makeupGain));
+        gainRampPrimed = true;
     }
     
+    // Ramp towards the new gain; a constant ratio per sample is a straight line in dB
+    gainRamp.setTargetValue(juce::Decibels::decibelsToGain(parameters.makeupGain - envelope));
+    gainRamp.applyGain(audioBlock);
+    
     currentGainReduction = envelope;
     return currentGainReduction;
 }
@@ -80,71 +87,75 @@ void Compressor::releaseResources()
 }
 
 //==============================================================================
-void Compressor::setThreshold(float thresholdDb)
+void Compressor::Parameters::prepare(double sampleRate)
 {
-    threshold = thresholdDb;
+    ratio = juce::jmax(1.0f, ratio);
+    attack = juce::jmax(0.1f, attack);
+    release = juce::jmax(1.0f, release);
+    knee = juce::jmax(0.0f, knee);
+
     if (autoMakeupGain)
     {
         // Calculate automatic makeup gain
         float compressionAmount = (threshold - (-60.0f)) / ratio;
         makeupGain = compressionAmount * 0.5f; // Conservative makeup gain
     }
+
+    // Using exponential approach for smooth envelope following
+    attackCoeff = std::exp(-1.0f / (attack * 0.001f * static_cast<float>(sampleRate)));
+    releaseCoeff = std::exp(-1.0f / (release * 0.001f * static_cast<float>(sampleRate)));
+}
+
+void Compressor::setThreshold(float thresholdDb)
+{
+    parameters.threshold = thresholdDb;
+    parameters.prepare(sampleRate);
 }
 
 void Compressor::setRatio(float ratio)
 {
-    this->ratio = juce::jmax(1.0f, ratio);
-    if (autoMakeupGain)
-    {
-        float compressionAmount = (threshold - (-60.0f)) / this->ratio;
-        makeupGain = compressionAmount * 0.5f;
-    }
+    parameters.ratio = ratio;
+    parameters.prepare(sampleRate);
 }
 
 void Compressor::setAttack(float attackMs)
 {
-    attack = juce::jmax(0.1f, attackMs);
-    updateCoefficients();
+    parameters.attack = attackMs;
+    parameters.prepare(sampleRate);
 }
 
 void Compressor::setRelease(float releaseMs)
 {
-    release = juce::jmax(1.0f, releaseMs);
-    updateCoefficients();
+    parameters.release = releaseMs;
+    parameters.prepare(sampleRate);
 }
 
 void Compressor::setKnee(float kneeDb)
 {
-    knee = juce::jmax(0.0f, kneeDb);
+    parameters.knee = kneeDb;
+    parameters.prepare(sampleRate);
 }
 
 void Compressor::setMakeupGain(float gainDb)
 {
-    makeupGain = gainDb;
-    autoMakeupGain = false;
+    parameters.makeupGain = gainDb;
+    parameters.autoMakeupGain = false;
+    parameters.prepare(sampleRate);
 }
 
 void Compressor::setAutoMakeupGain(bool enabled)
 {
-    autoMakeupGain = enabled;
-    if (enabled)
-    {
-        float compressionAmount = (threshold - (-60.0f)) / ratio;
-        makeupGain = compressionAmount * 0.5f;
-    }
+    parameters.autoMakeupGain = enabled;
+    parameters.prepare(sampleRate);
 }
 
 //==============================================================================
-void Compressor::updateCoefficients()
-{
-    // Calculate attack and release coefficients
-    // Using exponential approach for smooth envelope following
-    attackCoeff = std::exp(-1.0f / (attack * 0.001f * static_cast<float>(sampleRate)));
-    releaseCoeff = std::exp(-1.0f / (release * 0.001f * static_cast<float>(sampleRate)));
-}
-
 float Compressor::calculateGainReduction(float inputLevelDb)
 {
+    const float threshold = parameters.threshold;
+    const float ratio = parameters.ratio;
+    const float knee = parameters.knee;
+    
     if (inputLevelDb <= threshold)
         return 0.0f;
     
@@ -162,6 +173,10 @@ float Compressor::calculateGainReduction(float inputLevelDb)
 
 float Compressor::softKneeCompression(float inputLevelDb)
 {
+    const float threshold = parameters.threshold;
+    const float ratio = parameters.ratio;
+    const float knee = parameters.knee;
+    
     float kneeStart = threshold - (knee / 2.0f);
     float kneeEnd = threshold + (knee / 2.0f);
     
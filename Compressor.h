@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "GainRamp.h"
 
 //==============================================================================
 class Compressor
@@ -13,7 +14,30 @@ public:
     float processBlock(juce::dsp::AudioBlock<float>& audioBlock);
     void releaseResources();
     
-    // Parameter setters
+    // Complete parameter set. prepare() clamps the values and derives the
+    // envelope coefficients (and automatic makeup gain) for a sample rate,
+    // so setParameters() is a plain copy that is safe on the audio thread.
+    struct Parameters
+    {
+        float threshold = -20.0f;        // dB
+        float ratio = 4.0f;              // ratio
+        float attack = 1.0f;             // ms
+        float release = 30.0f;           // ms
+        float knee = 2.0f;               // dB
+        float makeupGain = 0.0f;         // dB (derived when autoMakeupGain is on)
+        bool autoMakeupGain = true;
+
+        // Derived by prepare()
+        float attackCoeff = 0.0f;
+        float releaseCoeff = 0.0f;
+
+        void prepare(double sampleRate);
+    };
+
+    void setParameters(const Parameters& newParameters) { parameters = newParameters; }
+    const Parameters& getParameters() const { return parameters; }
+
+    // Single-parameter setters (derive coefficients in place)
     void setThreshold(float thresholdDb);
     void setRatio(float ratio);
     void setAttack(float attackMs);
@@ -24,17 +48,10 @@ public:
     
     // Getters
     float getGainReduction() const { return currentGainReduction; }
-    float getMakeupGain() const { return makeupGain; }
+    float getMakeupGain() const { return parameters.makeupGain; }
     
 private:
-    // Parameters
-    float threshold = -20.0f;        // dB
-    float ratio = 4.0f;              // ratio
-    float attack = 1.0f;             // ms
-    float release = 30.0f;           // ms
-    float knee = 2.0f;               // dB
-    float makeupGain = 0.0f;         // dB
-    bool autoMakeupGain = true;
+    Parameters parameters;
     
     // Processing state
     double sampleRate = 44100.0;
@@ -42,12 +59,13 @@ private:
     
     // Envelope follower
     float envelope = 0.0f;
-    float attackCoeff = 0.0f;
-    float releaseCoeff = 0.0f;
     
     // Gain reduction
     float currentGainReduction = 0.0f;
-    juce::SmoothedValue<float> gainReductionSmoothed;
+    
+    // Applied gain (makeup minus reduction), ramped linearly in dB
+    GainRamp gainRamp { GainRamp::Shape::exponential };
+    bool gainRampPrimed = false;
     
     // RMS detection
     static constexpr int rmsWindowSize = 64;
@@ -55,7 +73,6 @@ private:
     int rmsIndex = 0;
     
     // Helper functions
-    void updateCoefficients();
     float calculateGainReduction(float inputLevel);
     float softKneeCompression(float inputLevel);
     float getRMSLevel(const juce::dsp::AudioBlock<float>& audioBlock);
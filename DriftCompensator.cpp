@@ -0,0 +1,101 @@
+#include "DriftCompensator.h"
+
+//==============================================================================
+void DriftCompensator::prepare(int numChannels, int maximumChunk)
+{
+    maximumChunkSize = juce::jmax(1, maximumChunk);
+    maximumInputFrames = static_cast<int>(std::ceil(maximumChunkSize * (1.0 + maximumCorrection))) + 2;
+
+    scratch.setSize(juce::jmax(1, numChannels), historySize + maximumInputFrames);
+    inputChannels.resize(static_cast<size_t>(scratch.getNumChannels()));
+
+    for (int channel = 0; channel < scratch.getNumChannels(); ++channel)
+        inputChannels[static_cast<size_t>(channel)] = scratch.getWritePointer(channel) + historySize;
+
+    readIndices.allocate(static_cast<size_t>(maximumChunkSize), true);
+    readFractions.allocate(static_cast<size_t>(maximumChunkSize), true);
+
+    ratio = 1.0;
+    smoothedError = 0.0;
+    integral = 0.0;
+    hasFillEstimate = false;
+    reset();
+}
+
+void DriftCompensator::reset() noexcept
+{
+    scratch.clear();
+    position = 1.0;
+}
+
+int DriftCompensator::getInputFramesNeeded(int numOutputFrames) const noexcept
+{
+    // Keeps the next chunk's read position in [1, 2): everything before it
+    // has been consumed, the historySize frames after it are carried over
+    return static_cast<int>(position + numOutputFrames * ratio) - 1;
+}
+
+void DriftCompensator::process(float* const* outputChannels, int outputOffset, int numOutputFrames) noexcept
+{
+    jassert(numOutputFrames <= maximumChunkSize);
+
+    const int inputFrames = getInputFramesNeeded(numOutputFrames);
+    jassert(inputFrames <= maximumInputFrames);
+
+    // Read positions are the same for every channel
+    for (int i = 0; i < numOutputFrames; ++i)
+    {
+        const double readPosition = position + i * ratio;
+        const int index = static_cast<int>(readPosition);
+        readIndices[i] = index;
+        readFractions[i] = static_cast<float>(readPosition - index);
+    }
+
+    for (int channel = 0; channel < scratch.getNumChannels(); ++channel)
+    {
+        float* lane = scratch.getWritePointer(channel);
+        float* output = outputChannels[channel] + outputOffset;
+
+        for (int i = 0; i < numOutputFrames; ++i)
+        {
+            const float* y = lane + readIndices[i];
+            const float t = readFractions[i];
+            const float ym1 = y[-1], y0 = y[0], y1 = y[1], y2 = y[2];
+
+            output[i] = y0 + 0.5f * t * (y1 - ym1
+                           + t * (2.0f * ym1 - 5.0f * y0 + 4.0f * y1 - y2
+                           + t * (3.0f * (y0 - y1) + y2 - ym1)));
+        }
+
+        // Carry the last frames over as the next chunk's history
+        std::memmove(lane, lane + inputFrames, historySize * sizeof(float));
+    }
+
+    position += numOutputFrames * ratio - inputFrames;
+}
+
+void DriftCompensator::updateRatio(int framesQueued, int targetFrames, int periodFrames, double sampleRate) noexcept
+{
+    if (sampleRate <= 0.0 || periodFrames <= 0)
+        return;
+
+    const double error = static_cast<double>(framesQueued - targetFrames);
+    const double elapsedSeconds = periodFrames / sampleRate;
+
+    // The fill level jumps by a producer block at a time; only its trend matters
+    if (hasFillEstimate)
+        smoothedError += (1.0 - std::exp(-elapsedSeconds / fillSmoothingSeconds)) * (error - smoothedError);
+    else
+        smoothedError = error;
+
+    hasFillEstimate = true;
+
+    // A ratio offset of kp * error drains that error with a settleSeconds time
+    // constant; the integral learns the steady drift between the two clocks
+    const double kp = 1.0 / (sampleRate * settleSeconds);
+    const double integralLimit = maximumCorrection * integralSeconds / kp;
+    integral = juce::jlimit(-integralLimit, integralLimit, integral + smoothedError * elapsedSeconds);
+
+    const double correction = kp * (smoothedError + integral / integralSeconds);
+    ratio = 1.0 + juce::jlimit(-maximumCorrection, maximumCorrection, correction);
+}
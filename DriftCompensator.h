@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Clock drift compensation for a FIFO between two independently clocked
+// audio threads.
+//
+// The consumer pulls its fixed-size periods through a cubic (Catmull-Rom)
+// variable-ratio resampler and reports the FIFO fill level once per period.
+// A low-passed fill error drives a PI controller that nudges the ratio by a
+// few hundred ppm, so that the consumer reads exactly as fast as the producer
+// writes and the FIFO settles at its target fill instead of slowly running
+// full or empty.
+//
+// Read positions are computed once per chunk and shared by all channels; the
+// per-channel loop is a branch-free polynomial the compiler can vectorise.
+// Everything is allocated in prepare(), the rest is realtime safe.
+class DriftCompensator
+{
+public:
+    DriftCompensator() = default;
+
+    // Output frames are processed in chunks of up to maximumChunkSize
+    void prepare(int numChannels, int maximumChunkSize);
+
+    // Silent history and a fresh read position, e.g. after an underrun. The
+    // learned drift is kept: the two clocks have not changed.
+    void reset() noexcept;
+
+    int getMaximumChunkSize() const noexcept { return maximumChunkSize; }
+
+    // Input frames the next process() call needs for numOutputFrames
+    // (at most getMaximumChunkSize()) output frames
+    int getInputFramesNeeded(int numOutputFrames) const noexcept;
+
+    // Where to write those input frames before calling process(), one pointer per channel
+    float* const* getInputChannels() noexcept { return inputChannels.data(); }
+
+    // Resamples the input frames written for getInputFramesNeeded(numOutputFrames)
+    void process(float* const* outputChannels, int outputOffset, int numOutputFrames) noexcept;
+
+    // Once per consumer period: FIFO fill level seen before reading, the
+    // level to hold, and the period length
+    void updateRatio(int framesQueued, int targetFrames, int periodFrames, double sampleRate) noexcept;
+
+    // Input frames consumed per output frame (above 1 while draining)
+    double getRatio() const noexcept { return ratio; }
+
+private:
+    static constexpr int historySize = 4;   // y[-1] .. y[2] of the Catmull-Rom kernel
+    static constexpr double maximumCorrection = 0.002;
+    static constexpr double fillSmoothingSeconds = 2.0;
+    static constexpr double settleSeconds = 5.0;
+    static constexpr double integralSeconds = 20.0;
+
+    int maximumChunkSize = 0;
+    int maximumInputFrames = 0;
+
+    double ratio = 1.0;
+    double position = 1.0;           // read position into the scratch lanes, in [1, 2)
+
+    // Controller state
+    double smoothedError = 0.0;      // frames
+    double integral = 0.0;           // frame-seconds
+    bool hasFillEstimate = false;
+
+    // Per channel: historySize frames kept from the previous chunk followed by
+    // the new input
+    juce::AudioBuffer<float> scratch;
+    std::vector<float*> inputChannels;
+    juce::HeapBlock<int> readIndices;
+    juce::HeapBlock<float> readFractions;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DriftCompensator)
+};
@@ -0,0 +1,414 @@
+#include "DummyAudioDevice.h"
+#include <limits>
+
+namespace
+{
+    // Written by the device thread only, so a plain load/store is enough
+    void storeMax(std::atomic<juce::int64>& value, juce::int64 candidate) noexcept
+    {
+        if (candidate > value.load(std::memory_order_relaxed))
+            value.store(candidate, std::memory_order_relaxed);
+    }
+
+    juce::BigInteger limitChannels(const juce::BigInteger& requested, int numAvailable)
+    {
+        juce::BigInteger active;
+
+        for (int channel = 0; channel < numAvailable; ++channel)
+            if (requested[channel])
+                active.setBit(channel);
+
+        return active;
+    }
+
+    juce::StringArray makeChannelNames(const juce::String& prefix, int numChannels)
+    {
+        juce::StringArray names;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            names.add(prefix + " " + juce::String(channel + 1));
+
+        return names;
+    }
+}
+
+//==============================================================================
+juce::String DummyAudioIODevice::Statistics::toString() const
+{
+    const auto formatMicros = [](double micros) { return juce::String(juce::roundToInt(micros)) + " us"; };
+
+    return juce::String(numCallbacks) + " callbacks, "
+         + juce::String(getRealtimeFactor(), 2) + "x realtime, "
+         + juce::String(missedDeadlines) + " missed deadlines, "
+         + "max callback " + formatMicros(maxCallbackMicros) + ", "
+         + "max wake lateness " + formatMicros(maxWakeLatenessMicros);
+}
+
+//==============================================================================
+DummyAudioIODevice::DummyAudioIODevice(const juce::String& deviceName, const juce::String& typeName, const Options& optionsToUse)
+    : juce::AudioIODevice(deviceName, typeName),
+      juce::Thread("Dummy audio device"),
+      options(optionsToUse)
+{
+}
+
+DummyAudioIODevice::~DummyAudioIODevice()
+{
+    close();
+}
+
+juce::StringArray DummyAudioIODevice::getOutputChannelNames()
+{
+    return makeChannelNames("Output", options.numOutputChannels);
+}
+
+juce::StringArray DummyAudioIODevice::getInputChannelNames()
+{
+    return makeChannelNames("Input", options.numInputChannels);
+}
+
+juce::Array<double> DummyAudioIODevice::getAvailableSampleRates()
+{
+    return { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+}
+
+juce::Array<int> DummyAudioIODevice::getAvailableBufferSizes()
+{
+    return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+}
+
+//==============================================================================
+juce::String DummyAudioIODevice::open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                                      double newSampleRate, int newBufferSize)
+{
+    close();
+    lastError.clear();
+
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+    bufferSize = newBufferSize > 0 ? newBufferSize : getDefaultBufferSize();
+    activeInputs = limitChannels(inputChannels, options.numInputChannels);
+    activeOutputs = limitChannels(outputChannels, options.numOutputChannels);
+
+    inputBuffer.setSize(activeInputs.countNumberOfSetBits(), bufferSize);
+    outputBuffer.setSize(activeOutputs.countNumberOfSetBits(), bufferSize);
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    // Preload the whole input so that the device thread never touches the disk
+    if (options.inputFile != juce::File())
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(options.inputFile));
+
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+        {
+            lastError = "Unsupported or unreadable input file: " + options.inputFile.getFullPathName();
+            return lastError;
+        }
+
+        if (reader->lengthInSamples > std::numeric_limits<int>::max())
+        {
+            lastError = "Input file too long: " + options.inputFile.getFullPathName();
+            return lastError;
+        }
+
+        const auto length = static_cast<int>(reader->lengthInSamples);
+        inputFileData.setSize(static_cast<int>(reader->numChannels), length);
+        reader->read(&inputFileData, 0, length, 0, true, true);
+
+        if (reader->sampleRate != sampleRate)
+            juce::Logger::writeToLog("Dummy device: " + options.inputFile.getFileName() + " is "
+                                     + juce::String(reader->sampleRate) + " Hz, played unconverted at "
+                                     + juce::String(sampleRate) + " Hz");
+    }
+
+    if (options.outputFile != juce::File())
+    {
+        auto* format = formatManager.findFormatForFileExtension(options.outputFile.getFileExtension());
+
+        if (format == nullptr)
+        {
+            lastError = "No audio format for output extension: " + options.outputFile.getFileName();
+            return lastError;
+        }
+
+        if (!options.outputFile.deleteFile())
+        {
+            lastError = "Cannot overwrite output file: " + options.outputFile.getFullPathName();
+            return lastError;
+        }
+
+        std::unique_ptr<juce::FileOutputStream> outputStream(options.outputFile.createOutputStream());
+        const auto depths = format->getPossibleBitDepths();
+
+        if (outputStream != nullptr)
+            writer.reset(format->createWriterFor(outputStream.get(), sampleRate,
+                                                 static_cast<unsigned int>(juce::jmax(1, outputBuffer.getNumChannels())),
+                                                 depths.contains(24) ? 24 : depths.getLast(), {}, 0));
+
+        if (writer == nullptr)
+        {
+            lastError = "Cannot create output file: " + options.outputFile.getFullPathName();
+            return lastError;
+        }
+
+        outputStream.release(); // now owned by the writer
+
+        if (options.speed > 0.0)
+        {
+            writerThread.startThread();
+            threadedWriter = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer.release(), writerThread,
+                                                                                        juce::jmax(1 << 16, bufferSize * 64));
+        }
+    }
+
+    opened = true;
+    return {};
+}
+
+void DummyAudioIODevice::close()
+{
+    stop();
+
+    threadedWriter.reset();     // flushes what is queued
+    writerThread.stopThread(2000);
+    writer.reset();
+
+    if (const auto dropped = droppedOutputSamples.exchange(0); dropped > 0)
+        juce::Logger::writeToLog("Dummy device: writer fell behind, dropped " + juce::String(dropped) + " output samples");
+
+    inputFileData.setSize(0, 0);
+    opened = false;
+}
+
+//==============================================================================
+void DummyAudioIODevice::start(juce::AudioIODeviceCallback* newCallback)
+{
+    if (!opened || newCallback == nullptr)
+        return;
+
+    stop();
+
+    newCallback->audioDeviceAboutToStart(this);
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        callback = newCallback;
+    }
+
+    numCallbacks.store(0);
+    missedDeadlines.store(0);
+    maxWakeLatenessTicks.store(0);
+    maxCallbackTicks.store(0);
+    inputFilePosition = 0;
+    sinePhase = 0.0;
+
+    startThread(juce::Thread::Priority::highest);
+}
+
+void DummyAudioIODevice::stop()
+{
+    stopThread(2000);
+
+    juce::AudioIODeviceCallback* oldCallback;
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        oldCallback = callback;
+        callback = nullptr;
+    }
+
+    if (oldCallback != nullptr)
+        oldCallback->audioDeviceStopped();
+}
+
+DummyAudioIODevice::Statistics DummyAudioIODevice::getStatistics() const
+{
+    const auto ticksToSeconds = [](juce::int64 ticks) { return juce::Time::highResolutionTicksToSeconds(ticks); };
+
+    Statistics statistics;
+    statistics.numCallbacks = numCallbacks.load();
+    statistics.missedDeadlines = missedDeadlines.load();
+    statistics.maxWakeLatenessMicros = ticksToSeconds(maxWakeLatenessTicks.load()) * 1.0e6;
+    statistics.maxCallbackMicros = ticksToSeconds(maxCallbackTicks.load()) * 1.0e6;
+    statistics.audioSeconds = static_cast<double>(statistics.numCallbacks) * bufferSize / sampleRate;
+    statistics.wallSeconds = ticksToSeconds(lastTicks.load() - startTicks.load());
+    return statistics;
+}
+
+//==============================================================================
+void DummyAudioIODevice::run()
+{
+    const bool paced = options.speed > 0.0;
+    const double periodTicks = paced ? bufferSize * static_cast<double>(juce::Time::getHighResolutionTicksPerSecond())
+                                           / (sampleRate * options.speed)
+                                     : 0.0;
+
+    // Periods are released on an absolute clock from here, so waking late
+    // never shifts the periods after it
+    const auto origin = juce::Time::getHighResolutionTicks();
+    startTicks.store(origin);
+    lastTicks.store(origin);
+
+    juce::int64 period = 0;
+
+    while (!threadShouldExit())
+    {
+        if (paced)
+        {
+            const auto release = origin + static_cast<juce::int64>(static_cast<double>(period) * periodTicks);
+            waitUntil(release);
+
+            if (threadShouldExit())
+                break;
+
+            storeMax(maxWakeLatenessTicks, juce::Time::getHighResolutionTicks() - release);
+        }
+
+        processPeriod();
+
+        const auto finished = juce::Time::getHighResolutionTicks();
+        lastTicks.store(finished);
+        numCallbacks.store(numCallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        ++period;
+
+        if (paced)
+        {
+            const auto nextRelease = origin + static_cast<juce::int64>(static_cast<double>(period) * periodTicks);
+
+            if (finished > nextRelease)
+            {
+                missedDeadlines.store(missedDeadlines.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+                // Periods whose start has already passed are lost, as they
+                // would be on hardware; rejoin the clock rather than burst
+                period = juce::jmax(period, static_cast<juce::int64>(static_cast<double>(finished - origin) / periodTicks));
+            }
+        }
+    }
+}
+
+void DummyAudioIODevice::processPeriod()
+{
+    fillInput();
+    outputBuffer.clear();
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+
+        if (callback != nullptr)
+        {
+            const auto begin = juce::Time::getHighResolutionTicks();
+
+            callback->audioDeviceIOCallbackWithContext(inputBuffer.getArrayOfReadPointers(), inputBuffer.getNumChannels(),
+                                                       outputBuffer.getArrayOfWritePointers(), outputBuffer.getNumChannels(),
+                                                       bufferSize, {});
+
+            storeMax(maxCallbackTicks, juce::Time::getHighResolutionTicks() - begin);
+        }
+    }
+
+    if (threadedWriter != nullptr)
+    {
+        if (!threadedWriter->write(outputBuffer.getArrayOfReadPointers(), bufferSize))
+            droppedOutputSamples.store(droppedOutputSamples.load() + bufferSize);
+    }
+    else if (writer != nullptr)
+    {
+        writer->writeFromAudioSampleBuffer(outputBuffer, 0, bufferSize);
+    }
+}
+
+void DummyAudioIODevice::fillInput()
+{
+    const int numChannels = inputBuffer.getNumChannels();
+
+    if (numChannels == 0)
+        return;
+
+    if (inputFileData.getNumSamples() > 0)
+    {
+        // Looped; file channels are repeated across wider inputs
+        for (int done = 0; done < bufferSize;)
+        {
+            const int count = juce::jmin(bufferSize - done, inputFileData.getNumSamples() - inputFilePosition);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                inputBuffer.copyFrom(channel, done, inputFileData, channel % inputFileData.getNumChannels(),
+                                     inputFilePosition, count);
+
+            done += count;
+            inputFilePosition = (inputFilePosition + count) % inputFileData.getNumSamples();
+        }
+
+        return;
+    }
+
+    // 440 Hz at -12 dBFS on every input
+    const double increment = juce::MathConstants<double>::twoPi * 440.0 / sampleRate;
+    auto* samples = inputBuffer.getWritePointer(0);
+
+    for (int i = 0; i < bufferSize; ++i)
+    {
+        samples[i] = 0.25f * static_cast<float>(std::sin(sinePhase));
+        sinePhase += increment;
+    }
+
+    sinePhase = std::fmod(sinePhase, juce::MathConstants<double>::twoPi);
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        inputBuffer.copyFrom(channel, 0, inputBuffer, 0, 0, bufferSize);
+}
+
+void DummyAudioIODevice::waitUntil(juce::int64 ticks)
+{
+    const auto ticksPerMs = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) * 0.001;
+
+    // Sleep while more than 2 ms away, then spin: scheduler wake-ups are
+    // too coarse for sub-millisecond periods
+    while (!threadShouldExit())
+    {
+        const double remainingMs = static_cast<double>(ticks - juce::Time::getHighResolutionTicks()) / ticksPerMs;
+
+        if (remainingMs <= 0.0)
+            break;
+
+        if (remainingMs > 2.0)
+            wait(static_cast<int>(remainingMs - 1.0));
+        else
+            juce::Thread::yield();
+    }
+}
+
+//==============================================================================
+DummyAudioIODeviceType::DummyAudioIODeviceType(const DummyAudioIODevice::Options& optionsToUse)
+    : juce::AudioIODeviceType(typeName),
+      options(optionsToUse)
+{
+}
+
+juce::StringArray DummyAudioIODeviceType::getDeviceNames(bool) const
+{
+    return { deviceName };
+}
+
+int DummyAudioIODeviceType::getDefaultDeviceIndex(bool) const
+{
+    return 0;
+}
+
+int DummyAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool) const
+{
+    return dynamic_cast<DummyAudioIODevice*>(device) != nullptr ? 0 : -1;
+}
+
+juce::AudioIODevice* DummyAudioIODeviceType::createDevice(const juce::String& outputDeviceName,
+                                                          const juce::String& inputDeviceName)
+{
+    const bool wantsDefault = outputDeviceName.isEmpty() && inputDeviceName.isEmpty();
+
+    if (!wantsDefault && outputDeviceName != deviceName && inputDeviceName != deviceName)
+        return nullptr;
+
+    return new DummyAudioIODevice(deviceName, typeName, options);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+// Hardware-free audio device for load and deadline testing on machines
+// without a sound card (CI, perf boxes).
+//
+// A high-priority thread drives the registered callback with exactly
+// bufferSize samples per period. Its input is a preloaded, looping audio
+// file or a fixed sine, and its output is discarded or written to a WAV
+// file, so a run is deterministic apart from timing.
+//
+// speed sets the pacing: 1.0 runs at realtime against an absolute period
+// clock, 4.0 paces at four times realtime, and 0 runs the callbacks back to
+// back for throughput tests. When paced, a callback that finishes after the
+// start of the next period counts as a missed deadline, and wake-up lateness
+// is tracked as jitter.
+class DummyAudioIODevice : public juce::AudioIODevice,
+                           private juce::Thread
+{
+public:
+    struct Options
+    {
+        double speed = 1.0;                 // multiple of realtime; 0 = as fast as possible
+        juce::File inputFile;               // looped; a 440 Hz sine at -12 dBFS when unset
+        juce::File outputFile;              // 24-bit WAV; discarded when unset
+        int numInputChannels = 2;
+        int numOutputChannels = 2;
+    };
+
+    struct Statistics
+    {
+        juce::int64 numCallbacks = 0;
+        juce::int64 missedDeadlines = 0;
+        double maxWakeLatenessMicros = 0.0; // paced runs only
+        double maxCallbackMicros = 0.0;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+
+        double getRealtimeFactor() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+        juce::String toString() const;
+    };
+
+    DummyAudioIODevice(const juce::String& deviceName, const juce::String& typeName, const Options& options);
+    ~DummyAudioIODevice() override;
+
+    // Since the last start()
+    Statistics getStatistics() const;
+
+    //==============================================================================
+    juce::StringArray getOutputChannelNames() override;
+    juce::StringArray getInputChannelNames() override;
+    juce::Array<double> getAvailableSampleRates() override;
+    juce::Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override { return 512; }
+
+    juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                      double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return opened; }
+
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override { return isThreadRunning(); }
+
+    juce::String getLastError() override { return lastError; }
+    int getCurrentBufferSizeSamples() override { return bufferSize; }
+    double getCurrentSampleRate() override { return sampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputs; }
+    juce::BigInteger getActiveInputChannels() const override { return activeInputs; }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override { return 0; }
+    int getXRunCount() const noexcept override { return static_cast<int>(missedDeadlines.load()); }
+
+private:
+    void run() override;
+    void processPeriod();
+    void fillInput();
+    void waitUntil(juce::int64 ticks);
+
+    const Options options;
+
+    double sampleRate = 48000.0;
+    int bufferSize = 512;
+    bool opened = false;
+    juce::String lastError;
+    juce::BigInteger activeInputs, activeOutputs;
+
+    juce::AudioBuffer<float> inputBuffer, outputBuffer;
+    juce::AudioBuffer<float> inputFileData;
+    int inputFilePosition = 0;
+    double sinePhase = 0.0;
+
+    // Paced runs hand the file writing to a background thread so that disk
+    // I/O does not land in the measured period
+    juce::TimeSliceThread writerThread { "Dummy device writer" };
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> threadedWriter;
+    std::atomic<juce::int64> droppedOutputSamples { 0 };
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* callback = nullptr;
+
+    // Written by the device thread, read by getStatistics()
+    std::atomic<juce::int64> numCallbacks { 0 };
+    std::atomic<juce::int64> missedDeadlines { 0 };
+    std::atomic<juce::int64> maxWakeLatenessTicks { 0 };
+    std::atomic<juce::int64> maxCallbackTicks { 0 };
+    std::atomic<juce::int64> startTicks { 0 };
+    std::atomic<juce::int64> lastTicks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DummyAudioIODevice)
+};
+
+//==============================================================================
+// Device type offering one DummyAudioIODevice, so that AudioDeviceManager
+// can select it like any hardware driver.
+class DummyAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    static constexpr const char* typeName = "Dummy";
+    static constexpr const char* deviceName = "Dummy Device";
+
+    explicit DummyAudioIODeviceType(const DummyAudioIODevice::Options& options = {});
+
+    void scanForDevices() override {}
+    juce::StringArray getDeviceNames(bool wantInputNames = false) const override;
+    int getDefaultDeviceIndex(bool forInput) const override;
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName,
+                                      const juce::String& inputDeviceName) override;
+
+private:
+    const DummyAudioIODevice::Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DummyAudioIODeviceType)
+};
@@ -0,0 +1,460 @@
+#include "GainComputer.h"
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define GAIN_COMPUTER_HAS_SSE2 1
+ #include <immintrin.h>
+ #if JUCE_GCC || JUCE_CLANG
+  #define GAIN_COMPUTER_AVX2_TARGET __attribute__ ((target ("avx2,fma")))
+ #else
+  #define GAIN_COMPUTER_AVX2_TARGET
+ #endif
+#endif
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ #define GAIN_COMPUTER_HAS_NEON 1
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+    //==============================================================================
+    // Polynomial coefficients (Chebyshev fits, degree 5).
+    // log2(1 + u), u in [0, 1): max abs error 1.7e-5  (~0.0001 dB)
+    // exp2(f),     f in [0, 1): max rel error 1.8e-7
+    constexpr float log2C0 = 1.651467088e-05f;
+    constexpr float log2C1 = 1.441492412e+00f;
+    constexpr float log2C2 = -7.064864491e-01f;
+    constexpr float log2C3 = 4.094702987e-01f;
+    constexpr float log2C4 = -1.874886046e-01f;
+    constexpr float log2C5 = 4.300495779e-02f;
+
+    constexpr float exp2C0 = 9.999998984e-01f;
+    constexpr float exp2C1 = 6.931544897e-01f;
+    constexpr float exp2C2 = 2.401418182e-01f;
+    constexpr float exp2C3 = 5.586033708e-02f;
+    constexpr float exp2C4 = 8.949590424e-03f;
+    constexpr float exp2C5 = 1.893754058e-03f;
+
+    constexpr float exp2MinInput = -126.0f;
+    constexpr float exp2MaxInput = 126.0f;
+
+    constexpr float log2Of10Over20 = 0.16609640474f; // dB -> log2(gain)
+    constexpr float minusInfinityDb = -100.0f;       // matches juce::Decibels default
+
+    //==============================================================================
+    // Scalar versions of the approximations, used for the tail of each block so
+    // that the SIMD kernels give the same answer regardless of alignment.
+    inline float approxLog2(float x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const float e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+        const uint32_t mantissaBits = (bits & 0x007fffffu) | 0x3f800000u;
+
+        float m;
+        std::memcpy(&m, &mantissaBits, sizeof(m));
+        const float u = m - 1.0f;
+
+        float p = log2C5;
+        p = p * u + log2C4;
+        p = p * u + log2C3;
+        p = p * u + log2C2;
+        p = p * u + log2C1;
+        p = p * u + log2C0;
+        return e + p;
+    }
+
+    inline float approxExp2(float x)
+    {
+        x = juce::jlimit(exp2MinInput, exp2MaxInput, x);
+
+        const float whole = std::floor(x);
+        const float f = x - whole;
+
+        float p = exp2C5;
+        p = p * f + exp2C4;
+        p = p * f + exp2C3;
+        p = p * f + exp2C2;
+        p = p * f + exp2C1;
+        p = p * f + exp2C0;
+
+        const uint32_t scaleBits = static_cast<uint32_t>(static_cast<int32_t>(whole) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &scaleBits, sizeof(scale));
+        return p * scale;
+    }
+
+    inline float approxPowerLawGain(float envelope, float thresholdLog2, float slope, bool belowThreshold)
+    {
+        float d = approxLog2(envelope) - thresholdLog2;
+        d = belowThreshold ? juce::jmin(d, 0.0f) : juce::jmax(d, 0.0f);
+        return approxExp2(slope * d);
+    }
+
+    inline float approxDecibelsToGain(float decibels)
+    {
+        return decibels > minusInfinityDb ? approxExp2(decibels * log2Of10Over20) : 0.0f;
+    }
+
+    //==============================================================================
+    // Scalar reference: the original per-sample formulation.
+    void powerLawScalarReference(const float* envelope, float* gains, int numSamples,
+                                 float thresholdGain, float ratio, bool belowThreshold)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float env = envelope[i];
+            float gain = 1.0f;
+
+            if (belowThreshold ? (env < thresholdGain) : (env > thresholdGain))
+            {
+                const float distance = belowThreshold ? thresholdGain / env : env / thresholdGain;
+                const float distanceDb = juce::Decibels::gainToDecibels(distance);
+                const float reductionDb = distanceDb - (distanceDb / ratio);
+                gain = juce::Decibels::decibelsToGain(-reductionDb);
+            }
+
+            gains[i] = gain;
+        }
+    }
+
+    void decibelsToGainsScalarReference(const float* decibels, float* gains, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            gains[i] = juce::Decibels::decibelsToGain(decibels[i]);
+    }
+
+   #if GAIN_COMPUTER_HAS_SSE2
+    //==============================================================================
+    inline __m128 log2Sse2(__m128 x)
+    {
+        const __m128i bits = _mm_castps_si128(x);
+        const __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        const __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                                       _mm_set1_epi32(0x3f800000)));
+        const __m128 u = _mm_sub_ps(m, _mm_set1_ps(1.0f));
+
+        __m128 p = _mm_set1_ps(log2C5);
+        p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(log2C4));
+        p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(log2C3));
+        p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(log2C2));
+        p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(log2C1));
+        p = _mm_add_ps(_mm_mul_ps(p, u), _mm_set1_ps(log2C0));
+        return _mm_add_ps(e, p);
+    }
+
+    inline __m128 exp2Sse2(__m128 x)
+    {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(exp2MinInput)), _mm_set1_ps(exp2MaxInput));
+
+        // floor() without SSE4.1: truncate, then step down where truncation rounded up
+        __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        whole = _mm_sub_ps(whole, _mm_and_ps(_mm_cmpgt_ps(whole, x), _mm_set1_ps(1.0f)));
+        const __m128 f = _mm_sub_ps(x, whole);
+
+        __m128 p = _mm_set1_ps(exp2C5);
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C4));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C3));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C2));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C1));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C0));
+
+        const __m128i scale = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(whole), _mm_set1_epi32(127)), 23);
+        return _mm_mul_ps(p, _mm_castsi128_ps(scale));
+    }
+
+    void powerLawSse2(const float* envelope, float* gains, int numSamples,
+                      float thresholdLog2, float slope, bool belowThreshold)
+    {
+        const __m128 thr = _mm_set1_ps(thresholdLog2);
+        const __m128 k = _mm_set1_ps(slope);
+        const __m128 zero = _mm_setzero_ps();
+
+        int i = 0;
+        for (; i <= numSamples - 4; i += 4)
+        {
+            __m128 d = _mm_sub_ps(log2Sse2(_mm_loadu_ps(envelope + i)), thr);
+            d = belowThreshold ? _mm_min_ps(d, zero) : _mm_max_ps(d, zero);
+            _mm_storeu_ps(gains + i, exp2Sse2(_mm_mul_ps(k, d)));
+        }
+
+        for (; i < numSamples; ++i)
+            gains[i] = approxPowerLawGain(envelope[i], thresholdLog2, slope, belowThreshold);
+    }
+
+    void decibelsToGainsSse2(const float* decibels, float* gains, int numSamples)
+    {
+        const __m128 scale = _mm_set1_ps(log2Of10Over20);
+        const __m128 floorDb = _mm_set1_ps(minusInfinityDb);
+
+        int i = 0;
+        for (; i <= numSamples - 4; i += 4)
+        {
+            const __m128 db = _mm_loadu_ps(decibels + i);
+            const __m128 g = exp2Sse2(_mm_mul_ps(db, scale));
+            _mm_storeu_ps(gains + i, _mm_and_ps(g, _mm_cmpgt_ps(db, floorDb)));
+        }
+
+        for (; i < numSamples; ++i)
+            gains[i] = approxDecibelsToGain(decibels[i]);
+    }
+
+    //==============================================================================
+    GAIN_COMPUTER_AVX2_TARGET inline __m256 log2Avx2(__m256 x)
+    {
+        const __m256i bits = _mm256_castps_si256(x);
+        const __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+        const __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                                             _mm256_set1_epi32(0x3f800000)));
+        const __m256 u = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+
+        __m256 p = _mm256_set1_ps(log2C5);
+        p = _mm256_fmadd_ps(p, u, _mm256_set1_ps(log2C4));
+        p = _mm256_fmadd_ps(p, u, _mm256_set1_ps(log2C3));
+        p = _mm256_fmadd_ps(p, u, _mm256_set1_ps(log2C2));
+        p = _mm256_fmadd_ps(p, u, _mm256_set1_ps(log2C1));
+        p = _mm256_fmadd_ps(p, u, _mm256_set1_ps(log2C0));
+        return _mm256_add_ps(e, p);
+    }
+
+    GAIN_COMPUTER_AVX2_TARGET inline __m256 exp2Avx2(__m256 x)
+    {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(exp2MinInput)), _mm256_set1_ps(exp2MaxInput));
+
+        const __m256 whole = _mm256_floor_ps(x);
+        const __m256 f = _mm256_sub_ps(x, whole);
+
+        __m256 p = _mm256_set1_ps(exp2C5);
+        p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(exp2C4));
+        p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(exp2C3));
+        p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(exp2C2));
+        p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(exp2C1));
+        p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(exp2C0));
+
+        const __m256i scale = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(whole), _mm256_set1_epi32(127)), 23);
+        return _mm256_mul_ps(p, _mm256_castsi256_ps(scale));
+    }
+
+    GAIN_COMPUTER_AVX2_TARGET void powerLawAvx2(const float* envelope, float* gains, int numSamples,
+                                                float thresholdLog2, float slope, bool belowThreshold)
+    {
+        const __m256 thr = _mm256_set1_ps(thresholdLog2);
+        const __m256 k = _mm256_set1_ps(slope);
+        const __m256 zero = _mm256_setzero_ps();
+
+        int i = 0;
+        for (; i <= numSamples - 8; i += 8)
+        {
+            __m256 d = _mm256_sub_ps(log2Avx2(_mm256_loadu_ps(envelope + i)), thr);
+            d = belowThreshold ? _mm256_min_ps(d, zero) : _mm256_max_ps(d, zero);
+            _mm256_storeu_ps(gains + i, exp2Avx2(_mm256_mul_ps(k, d)));
+        }
+
+        for (; i < numSamples; ++i)
+            gains[i] = approxPowerLawGain(envelope[i], thresholdLog2, slope, belowThreshold);
+    }
+
+    GAIN_COMPUTER_AVX2_TARGET void decibelsToGainsAvx2(const float* decibels, float* gains, int numSamples)
+    {
+        const __m256 scale = _mm256_set1_ps(log2Of10Over20);
+        const __m256 floorDb = _mm256_set1_ps(minusInfinityDb);
+
+        int i = 0;
+        for (; i <= numSamples - 8; i += 8)
+        {
+            const __m256 db = _mm256_loadu_ps(decibels + i);
+            const __m256 g = exp2Avx2(_mm256_mul_ps(db, scale));
+            _mm256_storeu_ps(gains + i, _mm256_and_ps(g, _mm256_cmp_ps(db, floorDb, _CMP_GT_OQ)));
+        }
+
+        for (; i < numSamples; ++i)
+            gains[i] = approxDecibelsToGain(decibels[i]);
+    }
+   #endif
+
+   #if GAIN_COMPUTER_HAS_NEON
+    //==============================================================================
+    inline float32x4_t log2Neon(float32x4_t x)
+    {
+        const uint32x4_t bits = vreinterpretq_u32_f32(x);
+        const float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+        const float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)),
+                                                              vdupq_n_u32(0x3f800000)));
+        const float32x4_t u = vsubq_f32(m, vdupq_n_f32(1.0f));
+
+        float32x4_t p = vdupq_n_f32(log2C5);
+        p = vmlaq_f32(vdupq_n_f32(log2C4), p, u);
+        p = vmlaq_f32(vdupq_n_f32(log2C3), p, u);
+        p = vmlaq_f32(vdupq_n_f32(log2C2), p, u);
+        p = vmlaq_f32(vdupq_n_f32(log2C1), p, u);
+        p = vmlaq_f32(vdupq_n_f32(log2C0), p, u);
+        return vaddq_f32(e, p);
+    }
+
+    inline float32x4_t exp2Neon(float32x4_t x)
+    {
+        x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(exp2MinInput)), vdupq_n_f32(exp2MaxInput));
+
+        // floor(): truncate, then step down where truncation rounded up
+        int32x4_t wholeInt = vcvtq_s32_f32(x);
+        const uint32x4_t roundedUp = vcgtq_f32(vcvtq_f32_s32(wholeInt), x);
+        wholeInt = vsubq_s32(wholeInt, vreinterpretq_s32_u32(vandq_u32(roundedUp, vdupq_n_u32(1))));
+        const float32x4_t f = vsubq_f32(x, vcvtq_f32_s32(wholeInt));
+
+        float32x4_t p = vdupq_n_f32(exp2C5);
+        p = vmlaq_f32(vdupq_n_f32(exp2C4), p, f);
+        p = vmlaq_f32(vdupq_n_f32(exp2C3), p, f);
+        p = vmlaq_f32(vdupq_n_f32(exp2C2), p, f);
+        p = vmlaq_f32(vdupq_n_f32(exp2C1), p, f);
+        p = vmlaq_f32(vdupq_n_f32(exp2C0), p, f);
+
+        const int32x4_t scale = vshlq_n_s32(vaddq_s32(wholeInt, vdupq_n_s32(127)), 23);
+        return vmulq_f32(p, vreinterpretq_f32_s32(scale));
+    }
+
+    void powerLawNeon(const float* envelope, float* gains, int numSamples,
+                      float thresholdLog2, float slope, bool belowThreshold)
+    {
+        const float32x4_t thr = vdupq_n_f32(thresholdLog2);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+
+        int i = 0;
+        for (; i <= numSamples - 4; i += 4)
+        {
+            float32x4_t d = vsubq_f32(log2Neon(vld1q_f32(envelope + i)), thr);
+            d = belowThreshold ? vminq_f32(d, zero) : vmaxq_f32(d, zero);
+            vst1q_f32(gains + i, exp2Neon(vmulq_n_f32(d, slope)));
+        }
+
+        for (; i < numSamples; ++i)
+            gains[i] = approxPowerLawGain(envelope[i], thresholdLog2, slope, belowThreshold);
+    }
+
+    void decibelsToGainsNeon(const float* decibels, float* gains, int numSamples)
+    {
+        const float32x4_t floorDb = vdupq_n_f32(minusInfinityDb);
+
+        int i = 0;
+        for (; i <= numSamples - 4; i += 4)
+        {
+            const float32x4_t db = vld1q_f32(decibels + i);
+            const float32x4_t g = exp2Neon(vmulq_n_f32(db, log2Of10Over20));
+            vst1q_f32(gains + i, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(g), vcgtq_f32(db, floorDb))));
+        }
+
+        for (; i < numSamples; ++i)
+            gains[i] = approxDecibelsToGain(decibels[i]);
+    }
+   #endif
+
+    //==============================================================================
+    void computePowerLawGains(GainComputer::Kernel kernel, const float* envelope, float* gains, int numSamples,
+                              float thresholdGain, float ratio, bool belowThreshold)
+    {
+        const float slope = (1.0f - 1.0f / ratio) * (belowThreshold ? 1.0f : -1.0f);
+        const float thresholdLog2 = std::log2(thresholdGain);
+
+        switch (kernel)
+        {
+           #if GAIN_COMPUTER_HAS_SSE2
+            case GainComputer::Kernel::avx2:
+                powerLawAvx2(envelope, gains, numSamples, thresholdLog2, slope, belowThreshold);
+                return;
+            case GainComputer::Kernel::sse2:
+                powerLawSse2(envelope, gains, numSamples, thresholdLog2, slope, belowThreshold);
+                return;
+           #endif
+           #if GAIN_COMPUTER_HAS_NEON
+            case GainComputer::Kernel::neon:
+                powerLawNeon(envelope, gains, numSamples, thresholdLog2, slope, belowThreshold);
+                return;
+           #endif
+            default:
+                powerLawScalarReference(envelope, gains, numSamples, thresholdGain, ratio, belowThreshold);
+                return;
+        }
+    }
+}
+
+//==============================================================================
+GainComputer::GainComputer()
+{
+    kernel.store(getBestAvailableKernel());
+}
+
+void GainComputer::setKernel(Kernel newKernel)
+{
+    kernel.store(isKernelAvailable(newKernel) ? newKernel : Kernel::scalarReference);
+}
+
+GainComputer::Kernel GainComputer::getBestAvailableKernel()
+{
+    if (isKernelAvailable(Kernel::avx2))
+        return Kernel::avx2;
+
+    if (isKernelAvailable(Kernel::sse2))
+        return Kernel::sse2;
+
+    if (isKernelAvailable(Kernel::neon))
+        return Kernel::neon;
+
+    return Kernel::scalarReference;
+}
+
+bool GainComputer::isKernelAvailable(Kernel kernelToCheck)
+{
+    switch (kernelToCheck)
+    {
+       #if GAIN_COMPUTER_HAS_SSE2
+        case Kernel::sse2:  return true;
+        case Kernel::avx2:  return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+       #endif
+       #if GAIN_COMPUTER_HAS_NEON
+        case Kernel::neon:  return true;
+       #endif
+        case Kernel::scalarReference:  return true;
+        default:                       return false;
+    }
+}
+
+juce::String GainComputer::getKernelName(Kernel kernelToCheck)
+{
+    switch (kernelToCheck)
+    {
+        case Kernel::sse2:  return "SSE2";
+        case Kernel::avx2:  return "AVX2";
+        case Kernel::neon:  return "NEON";
+        default:            return "Scalar";
+    }
+}
+
+//==============================================================================
+void GainComputer::computeExpanderGains(const float* envelope, float* gains, int numSamples,
+                                        float thresholdGain, float ratio) const
+{
+    computePowerLawGains(kernel.load(std::memory_order_relaxed), envelope, gains, numSamples,
+                         thresholdGain, juce::jmax(1.0f, ratio), true);
+}
+
+void GainComputer::computeCompressorGains(const float* envelope, float* gains, int numSamples,
+                                          float thresholdGain, float ratio) const
+{
+    computePowerLawGains(kernel.load(std::memory_order_relaxed), envelope, gains, numSamples,
+                         thresholdGain, juce::jmax(1.0f, ratio), false);
+}
+
+void GainComputer::decibelsToGains(const float* decibels, float* gains, int numSamples) const
+{
+    switch (kernel.load(std::memory_order_relaxed))
+    {
+       #if GAIN_COMPUTER_HAS_SSE2
+        case Kernel::avx2:  decibelsToGainsAvx2(decibels, gains, numSamples); return;
+        case Kernel::sse2:  decibelsToGainsSse2(decibels, gains, numSamples); return;
+       #endif
+       #if GAIN_COMPUTER_HAS_NEON
+        case Kernel::neon:  decibelsToGainsNeon(decibels, gains, numSamples); return;
+       #endif
+        default:            decibelsToGainsScalarReference(decibels, gains, numSamples); return;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+// Block-oriented static gain computer shared by the gate and compressor.
+//
+// Callers first write detector envelopes for a whole block into a scratch
+// buffer, then convert them into linear gains in one pass. The SIMD kernels
+// use polynomial log2/exp2 approximations (gain error below 0.001 dB); the
+// scalar kernel goes through juce::Decibels and is kept as the reference.
+class GainComputer
+{
+public:
+    enum class Kernel
+    {
+        scalarReference,
+        sse2,
+        avx2,
+        neon
+    };
+
+    GainComputer();
+
+    // Kernel selection (defaults to the fastest one the CPU supports)
+    void setKernel(Kernel newKernel);
+    Kernel getKernel() const { return kernel.load(); }
+    static Kernel getBestAvailableKernel();
+    static bool isKernelAvailable(Kernel kernelToCheck);
+    static juce::String getKernelName(Kernel kernelToCheck);
+
+    // Downward expander (noise gate): below the threshold the level is pushed
+    // down by (1 - 1/ratio) dB per dB under, i.e. gain = (env / thr)^(1 - 1/ratio).
+    void computeExpanderGains(const float* envelope, float* gains, int numSamples,
+                              float thresholdGain, float ratio) const;
+
+    // Downward compressor: above the threshold gain = (env / thr)^-(1 - 1/ratio).
+    void computeCompressorGains(const float* envelope, float* gains, int numSamples,
+                                float thresholdGain, float ratio) const;
+
+    // gains[i] = 10^(decibels[i] / 20)
+    void decibelsToGains(const float* decibels, float* gains, int numSamples) const;
+
+private:
+    std::atomic<Kernel> kernel { Kernel::scalarReference };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainComputer)
+};
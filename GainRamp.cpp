@@ -0,0 +1,187 @@
+#include "GainRamp.h"
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define GAIN_RAMP_HAS_SSE2 1
+ #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ #define GAIN_RAMP_HAS_NEON 1
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+    //==============================================================================
+    // destination[i] = start + step * (i + 1)
+    void fillArithmetic(float* destination, int numSamples, float start, float step) noexcept
+    {
+        int i = 0;
+
+       #if GAIN_RAMP_HAS_SSE2
+        const __m128 base = _mm_set1_ps(start);
+        const __m128 increment = _mm_set1_ps(step);
+        const __m128 stride = _mm_set1_ps(4.0f);
+        __m128 index = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+
+        for (; i <= numSamples - 4; i += 4)
+        {
+            _mm_storeu_ps(destination + i, _mm_add_ps(base, _mm_mul_ps(increment, index)));
+            index = _mm_add_ps(index, stride);
+        }
+       #elif GAIN_RAMP_HAS_NEON
+        const float32x4_t base = vdupq_n_f32(start);
+        const float32x4_t stride = vdupq_n_f32(4.0f);
+        const float indices[] = { 1.0f, 2.0f, 3.0f, 4.0f };
+        float32x4_t index = vld1q_f32(indices);
+
+        for (; i <= numSamples - 4; i += 4)
+        {
+            vst1q_f32(destination + i, vmlaq_n_f32(base, index, step));
+            index = vaddq_f32(index, stride);
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            destination[i] = start + step * static_cast<float>(i + 1);
+    }
+
+    // destination[i] = start * ratio^(i + 1)
+    void fillGeometric(float* destination, int numSamples, float start, float ratio) noexcept
+    {
+        int i = 0;
+        float value = start;
+
+       #if GAIN_RAMP_HAS_SSE2 || GAIN_RAMP_HAS_NEON
+        const float ratio2 = ratio * ratio;
+        const float ratio4 = ratio2 * ratio2;
+        const float lanes[] = { start * ratio, start * ratio2, start * ratio2 * ratio, start * ratio4 };
+       #endif
+
+       #if GAIN_RAMP_HAS_SSE2
+        const __m128 stride = _mm_set1_ps(ratio4);
+        __m128 values = _mm_loadu_ps(lanes);
+
+        for (; i <= numSamples - 4; i += 4)
+        {
+            _mm_storeu_ps(destination + i, values);
+            values = _mm_mul_ps(values, stride);
+        }
+       #elif GAIN_RAMP_HAS_NEON
+        float32x4_t values = vld1q_f32(lanes);
+
+        for (; i <= numSamples - 4; i += 4)
+        {
+            vst1q_f32(destination + i, values);
+            values = vmulq_n_f32(values, ratio4);
+        }
+       #endif
+
+        if (i > 0)
+            value = destination[i - 1];
+
+        for (; i < numSamples; ++i)
+        {
+            value *= ratio;
+            destination[i] = value;
+        }
+    }
+}
+
+//==============================================================================
+GainRamp::GainRamp(Shape shapeToUse, float initialValue)
+    : shape(shapeToUse), currentValue(initialValue), targetValue(initialValue)
+{
+}
+
+void GainRamp::prepare(double sampleRate, int maximumBlockSize, double rampLengthSeconds)
+{
+    rampLengthSamples = juce::roundToInt(sampleRate * rampLengthSeconds);
+
+    // Only grows, so preparing again for the same block size never allocates
+    if (maximumBlockSize > rampBufferSize || rampBufferSize == 0)
+    {
+        rampBufferSize = juce::jmax(1, maximumBlockSize);
+        rampBuffer.allocate(static_cast<size_t>(rampBufferSize), true);
+    }
+
+    setCurrentAndTargetValue(targetValue);
+}
+
+void GainRamp::setCurrentAndTargetValue(float newValue) noexcept
+{
+    currentValue = targetValue = newValue;
+    countdown = 0;
+}
+
+void GainRamp::setTargetValue(float newTarget) noexcept
+{
+    if (newTarget == targetValue)
+        return;
+
+    if (rampLengthSamples <= 0)
+    {
+        setCurrentAndTargetValue(newTarget);
+        return;
+    }
+
+    targetValue = newTarget;
+    countdown = rampLengthSamples;
+    stepIsRatio = shape == Shape::exponential && currentValue > 0.0f && targetValue > 0.0f;
+
+    if (stepIsRatio)
+        step = std::exp((std::log(targetValue) - std::log(currentValue)) / static_cast<float>(countdown));
+    else
+        step = (targetValue - currentValue) / static_cast<float>(countdown);
+}
+
+void GainRamp::fillRamp(float* destination, int numSamples) noexcept
+{
+    const int rampSamples = juce::jmin(countdown, numSamples);
+
+    if (rampSamples > 0)
+    {
+        if (stepIsRatio)
+            fillGeometric(destination, rampSamples, currentValue, step);
+        else
+            fillArithmetic(destination, rampSamples, currentValue, step);
+
+        countdown -= rampSamples;
+
+        // Land exactly on the target rather than on the accumulated ramp
+        if (countdown == 0)
+            destination[rampSamples - 1] = targetValue;
+
+        currentValue = destination[rampSamples - 1];
+    }
+
+    if (rampSamples < numSamples)
+        juce::FloatVectorOperations::fill(destination + rampSamples, currentValue, numSamples - rampSamples);
+}
+
+void GainRamp::applyGain(juce::dsp::AudioBlock<float>& audioBlock) noexcept
+{
+    const int numChannels = static_cast<int>(audioBlock.getNumChannels());
+    const int numSamples = static_cast<int>(audioBlock.getNumSamples());
+
+    // Not prepared: there is nowhere to write a ramp, so jump
+    if (rampBufferSize == 0)
+        setCurrentAndTargetValue(targetValue);
+
+    int offset = 0;
+
+    for (; offset < numSamples && isSmoothing(); offset += rampBufferSize)
+    {
+        const int chunk = juce::jmin(rampBufferSize, numSamples - offset);
+        fillRamp(rampBuffer.get(), chunk);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::multiply(audioBlock.getChannelPointer(static_cast<size_t>(channel)) + offset,
+                                                  rampBuffer.get(), chunk);
+    }
+
+    // Whatever is left after the ramp has landed is a static gain
+    if (offset < numSamples && currentValue != 1.0f)
+    {
+        auto remainder = audioBlock.getSubBlock(static_cast<size_t>(offset), static_cast<size_t>(numSamples - offset));
+        remainder.multiplyBy(currentValue);
+    }
+}
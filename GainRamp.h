@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Per-sample parameter smoother that writes whole ramps instead of stepping
+// one value at a time.
+//
+// setTargetValue() starts a ramp of fixed length from the current value;
+// fillRamp() writes the next values of that ramp into a buffer with SIMD, and
+// applyGain() multiplies a block by it. Once the ramp has landed, applyGain()
+// falls back to a single static multiply (or nothing at unity), so holding a
+// value costs no more than a plain gain.
+//
+// Linear ramps move by a constant step. Exponential ramps move by a constant
+// ratio, i.e. linearly in dB; they need both ends above zero and fall back to
+// a linear ramp otherwise.
+class GainRamp
+{
+public:
+    enum class Shape
+    {
+        linear,
+        exponential
+    };
+
+    explicit GainRamp(Shape shape = Shape::linear, float initialValue = 1.0f);
+
+    // Allocates the ramp scratch for applyGain() and sets the ramp length.
+    // Any ramp in progress is finished immediately.
+    void prepare(double sampleRate, int maximumBlockSize, double rampLengthSeconds);
+
+    void setCurrentAndTargetValue(float newValue) noexcept;
+    void setTargetValue(float newTarget) noexcept;
+
+    float getCurrentValue() const noexcept { return currentValue; }
+    float getTargetValue() const noexcept { return targetValue; }
+    bool isSmoothing() const noexcept { return countdown > 0; }
+
+    // Writes the next numSamples values into destination and advances the ramp
+    void fillRamp(float* destination, int numSamples) noexcept;
+
+    // Multiplies every channel of the block by the ramp
+    void applyGain(juce::dsp::AudioBlock<float>& audioBlock) noexcept;
+
+private:
+    Shape shape;
+
+    float currentValue;
+    float targetValue;
+    float step = 0.0f;                   // added (linear) or multiplied (exponential) per sample
+    bool stepIsRatio = false;
+    int countdown = 0;                   // samples left in the current ramp
+    int rampLengthSamples = 0;
+
+    juce::HeapBlock<float> rampBuffer;
+    int rampBufferSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainRamp)
+};
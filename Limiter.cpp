@@ -7,6 +7,8 @@ Limiter::Limiter()
     boxFilterBuffers.resize(numBoxFilters);
     boxFilterIndices.resize(numBoxFilters, 0);
     boxFilterSums.resize(numBoxFilters, 0.0f);
+    
+    parameters.prepare(sampleRate);
 }
 
 Limiter::~Limiter()
@@ -14,33 +16,30 @@ Limiter::~Limiter()
     releaseResources();
 }
 
-void Limiter::prepareToPlay(double sampleRate, int samplesPerBlock)
+void Limiter::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
     this->sampleRate = sampleRate;
     this->blockSize = samplesPerBlock;
     
-    updateLookaheadSize();
-    updateReleaseCoeff();
+    parameters.prepare(sampleRate);
+    
+    // Allocate for the longest lookahead up front; the active window
+    // length can then change on the audio thread without reallocating
+    const int maxLookaheadSamples = juce::jmax(1, static_cast<int>(maxLookaheadMs * 0.001 * sampleRate));
     
     // Initialize delay buffer
-    int delayBufferSize = lookaheadSamples + samplesPerBlock;
-    delayBuffer.setSize(2, delayBufferSize);
+    delayBuffer.setSize(juce::jmax(1, numChannels), maxLookaheadSamples + 1);
     delayBuffer.clear();
     delayWriteIndex = 0;
     
-    // Initialize peak hold buffer
-    peakHoldSize = lookaheadSamples;
-    peakHoldBuffer.resize(peakHoldSize, 1.0f);
-    peakHoldIndex = 0;
+    // Initialize peak hold and box filter buffers
+    peakHoldValues.assign(static_cast<size_t>(maxLookaheadSamples), 1.0f);
+    peakHoldTimes.assign(static_cast<size_t>(maxLookaheadSamples), 0);
     
-    // Initialize box filter buffers
-    int filterSize = lookaheadSamples / numBoxFilters;
-    for (int i = 0; i < numBoxFilters; ++i)
-    {
-        boxFilterBuffers[i].resize(filterSize, 1.0f);
-        boxFilterIndices[i] = 0;
-        boxFilterSums[i] = static_cast<float>(filterSize);
-    }
+    for (auto& buffer : boxFilterBuffers)
+        buffer.assign(static_cast<size_t>(maxLookaheadSamples / numBoxFilters), 1.0f);
+    
+    updateLookaheadSize();
     
     gainEnvelope = 1.0f;
     currentGainReduction = 0.0f;
@@ -48,7 +47,9 @@ void Limiter::prepareToPlay(double sampleRate, int samplesPerBlock)
 
 float Limiter::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
 {
-    const int numChannels = static_cast<int>(audioBlock.getNumChannels());
+    jassert(static_cast<int>(audioBlock.getNumChannels()) <= delayBuffer.getNumChannels());
+    
+    const int numChannels = juce::jmin(static_cast<int>(audioBlock.getNumChannels()), delayBuffer.getNumChannels());
     const int numSamples = static_cast<int>(audioBlock.getNumSamples());
     
     float maxGainReduction = 0.0f;
@@ -81,7 +82,7 @@ float Limiter::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
         else
         {
             // Exponential release
-            gainEnvelope += (smoothedGain - gainEnvelope) * (1.0f - releaseCoeff);
+            gainEnvelope += (smoothedGain - gainEnvelope) * (1.0f - parameters.releaseCoeff);
         }
         
         // Store delayed samples and apply gain to delayed audio
@@ -113,41 +114,85 @@ float Limiter::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
 void Limiter::releaseResources()
 {
     delayBuffer.clear();
-    peakHoldBuffer.clear();
+    peakHoldValues.clear();
+    peakHoldTimes.clear();
     
     for (auto& buffer : boxFilterBuffers)
         buffer.clear();
 }
 
 //==============================================================================
+void Limiter::Parameters::prepare(double sampleRate)
+{
+    lookahead = juce::jlimit(0.1f, maxLookaheadMs, lookahead);
+    release = juce::jmax(1.0f, release);
+
+    ceilingGain = juce::Decibels::decibelsToGain(ceiling);
+    releaseCoeff = std::exp(-1.0f / (release * 0.001f * static_cast<float>(sampleRate)));
+    lookaheadSamples = juce::jmax(1, static_cast<int>(lookahead * 0.001 * sampleRate));
+}
+
+void Limiter::setParameters(const Parameters& newParameters)
+{
+    const bool lookaheadChanged = newParameters.lookaheadSamples != parameters.lookaheadSamples;
+    parameters = newParameters;
+    
+    // Changing the window resets the peak hold, so only do it on a real change
+    if (lookaheadChanged)
+        updateLookaheadSize();
+}
+
 void Limiter::setCeiling(float ceilingDb)
 {
-    ceiling = ceilingDb;
+    auto newParameters = parameters;
+    newParameters.ceiling = ceilingDb;
+    newParameters.prepare(sampleRate);
+    setParameters(newParameters);
 }
 
 void Limiter::setLookahead(float lookaheadMs)
 {
-    lookahead = juce::jmax(0.1f, lookaheadMs);
-    updateLookaheadSize();
+    auto newParameters = parameters;
+    newParameters.lookahead = lookaheadMs;
+    newParameters.prepare(sampleRate);
+    setParameters(newParameters);
 }
 
 void Limiter::setRelease(float releaseMs)
 {
-    releaseTime = juce::jmax(1.0f, releaseMs);
-    updateReleaseCoeff();
+    auto newParameters = parameters;
+    newParameters.release = releaseMs;
+    newParameters.prepare(sampleRate);
+    setParameters(newParameters);
 }
 
 //==============================================================================
 void Limiter::updateLookaheadSize()
 {
-    lookaheadSamples = static_cast<int>(lookahead * 0.001 * sampleRate);
-    lookaheadSamples = juce::jmax(1, lookaheadSamples);
+    lookaheadSamples = parameters.lookaheadSamples;
+    
+    // Not prepared yet: prepareToPlay will size the windows
+    if (peakHoldValues.empty())
+        return;
+    
+    lookaheadSamples = juce::jmin(lookaheadSamples, static_cast<int>(peakHoldValues.size()));
+    resetLookaheadWindows();
 }
 
-void Limiter::updateReleaseCoeff()
+void Limiter::resetLookaheadWindows()
 {
-    // Calculate exponential release coefficient
-    releaseCoeff = std::exp(-1.0f / (releaseTime * 0.001f * static_cast<float>(sampleRate)));
+    peakHoldSize = lookaheadSamples;
+    peakHoldHead = 0;
+    peakHoldCount = 0;
+    peakHoldClock = 0;
+    
+    boxFilterLength = lookaheadSamples / numBoxFilters;
+    for (int i = 0; i < numBoxFilters; ++i)
+    {
+        std::fill(boxFilterBuffers[i].begin(), boxFilterBuffers[i].begin() + boxFilterLength, 1.0f);
+        boxFilterIndices[i] = 0;
+        boxFilterSums[i] = static_cast<float>(boxFilterLength);
+    }
 }
 
 float Limiter::calculateRequiredGain(float sampleValue)
@@ -155,7 +200,7 @@ float Limiter::calculateRequiredGain(float sampleValue)
     if (sampleValue == 0.0f)
         return 1.0f;
     
-    float ceilingLinear = juce::Decibels::decibelsToGain(ceiling);
+    const float ceilingLinear = parameters.ceilingGain;
     
     if (sampleValue <= ceilingLinear)
         return 1.0f;
@@ -165,24 +210,43 @@ float Limiter::calculateRequiredGain(float sampleValue)
 
 float Limiter::applyPeakHold(float gainValue)
 {
-    // Store current gain value in peak hold buffer
-    peakHoldBuffer[peakHoldIndex] = gainValue;
-    peakHoldIndex = (peakHoldIndex + 1) % peakHoldSize;
+    const int capacity = static_cast<int>(peakHoldValues.size());
+    const uint32_t now = peakHoldClock++;
+    
+    // Drop the oldest entry once it falls out of the window
+    if (peakHoldCount > 0 && now - peakHoldTimes[peakHoldHead] >= static_cast<uint32_t>(peakHoldSize))
+    {
+        peakHoldHead = (peakHoldHead + 1) % capacity;
+        --peakHoldCount;
+    }
     
-    // Find minimum gain in the peak hold window
-    float minGain = 1.0f;
-    for (float gain : peakHoldBuffer)
+    // Drop newer entries that can no longer be the minimum
+    while (peakHoldCount > 0)
     {
-        minGain = juce::jmin(minGain, gain);
+        const int tail = (peakHoldHead + peakHoldCount - 1) % capacity;
+        if (peakHoldValues[tail] < gainValue)
+            break;
+        --peakHoldCount;
     }
     
-    return minGain;
+    // Store current gain value at the back
+    const int slot = (peakHoldHead + peakHoldCount) % capacity;
+    peakHoldValues[slot] = gainValue;
+    peakHoldTimes[slot] = now;
+    ++peakHoldCount;
+    
+    // Front of the deque is the minimum gain in the peak hold window
+    // (the window starts out filled with unity gain)
+    return juce::jmin(1.0f, peakHoldValues[peakHoldHead]);
 }
 
 float Limiter::applySmoothingFilter(float gainValue)
 {
     float smoothedValue = gainValue;
     
+    if (boxFilterLength == 0)
+        return smoothedValue;
+    
     // Apply cascaded box filters for smooth gain curve
     for (int filterIndex = 0; filterIndex < numBoxFilters; ++filterIndex)
     {
@@ -190,9 +254,6 @@ float Limiter::applySmoothingFilter(float gainValue)
         auto& index = boxFilterIndices[filterIndex];
         auto& sum = boxFilterSums[filterIndex];
         
-        if (buffer.empty())
-            continue;
-        
         // Remove old value from sum
         sum -= buffer[index];
         
@@ -201,12 +262,11 @@ float Limiter::applySmoothingFilter(float gainValue)
         sum += smoothedValue;
         
         // Calculate filtered output
-        smoothedValue = sum / static_cast<float>(buffer.size());
+        smoothedValue = sum / static_cast<float>(boxFilterLength);
         
         // Update index
-        index = (index + 1) % static_cast<int>(buffer.size());
+        index = (index + 1) % boxFilterLength;
     }
     
     return smoothedValue;
 }
-
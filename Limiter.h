@@ -9,11 +9,32 @@ public:
     Limiter();
     ~Limiter();
     
-    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels = 2);
     float processBlock(juce::dsp::AudioBlock<float>& audioBlock);
     void releaseResources();
     
-    // Parameter setters
+    // Complete parameter set. prepare() clamps the values and derives the
+    // linear ceiling, release coefficient and lookahead length for a sample
+    // rate, so setParameters() does no maths and is safe on the audio thread.
+    struct Parameters
+    {
+        float ceiling = -0.3f;           // dB
+        float lookahead = 3.0f;          // ms
+        float release = 300.0f;          // ms
+
+        // Derived by prepare()
+        float ceilingGain = 1.0f;
+        float releaseCoeff = 0.0f;
+        int lookaheadSamples = 1;
+
+        void prepare(double sampleRate);
+    };
+
+    // A new lookahead length restarts the peak hold window
+    void setParameters(const Parameters& newParameters);
+    const Parameters& getParameters() const { return parameters; }
+
+    // Single-parameter setters (derive coefficients in place)
     void setCeiling(float ceilingDb);
     void setLookahead(float lookaheadMs);
     void setRelease(float releaseMs);
@@ -22,34 +43,39 @@ public:
     float getGainReduction() const { return currentGainReduction; }
     int getLatencySamples() const { return lookaheadSamples; }
     
+    // Buffers are sized for this much lookahead so it can change while running
+    static constexpr float maxLookaheadMs = 10.0f;
+    
 private:
-    // Parameters
-    float ceiling = -0.3f;           // dB
-    float lookahead = 3.0f;          // ms
-    float releaseTime = 300.0f;      // ms
+    Parameters parameters;
     
     // Processing state
     double sampleRate = 44100.0;
     int blockSize = 512;
-    int lookaheadSamples = 0;
+    int lookaheadSamples = 0;        // applied (clamped to the prepared capacity)
     
     // Delay line for lookahead
     juce::AudioBuffer<float> delayBuffer;
     int delayWriteIndex = 0;
     
-    // Peak hold for moving minimum
-    std::vector<float> peakHoldBuffer;
+    // Peak hold: sliding-window minimum over the last peakHoldSize gains,
+    // kept as a monotonic deque (ring of capacity maxLookaheadMs) so each
+    // sample costs amortised O(1) regardless of lookahead length
+    std::vector<float> peakHoldValues;
+    std::vector<uint32_t> peakHoldTimes;
     int peakHoldSize = 0;
-    int peakHoldIndex = 0;
+    int peakHoldHead = 0;
+    int peakHoldCount = 0;
+    uint32_t peakHoldClock = 0;
     
     // Smoothing filter (cascaded box filters)
     static constexpr int numBoxFilters = 4;
     std::vector<std::vector<float>> boxFilterBuffers;
     std::vector<int> boxFilterIndices;
     std::vector<float> boxFilterSums;
+    int boxFilterLength = 0;
     
     // Exponential release
-    float releaseCoeff = 0.0f;
     float gainEnvelope = 1.0f;
     
     // Gain reduction tracking
@@ -57,7 +83,7 @@ private:
     
     // Helper functions
     void updateLookaheadSize();
-    void updateReleaseCoeff();
+    void resetLookaheadWindows();
     float calculateRequiredGain(float sampleValue);
     float applyPeakHold(float gainValue);
     float applySmoothingFilter(float gainValue);
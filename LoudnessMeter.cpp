@@ -0,0 +1,300 @@
+#include "LoudnessMeter.h"
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter()
+{
+    updateFilters(48000.0);
+    reset();
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    releaseResources();
+}
+
+void LoudnessMeter::prepareToPlay(double sampleRate, int numChannels)
+{
+    subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    channelStates.assign(static_cast<size_t>(juce::jmax(1, numChannels)), ChannelState());
+
+    updateFilters(sampleRate);
+    reset();
+}
+
+void LoudnessMeter::processBlock(const juce::dsp::AudioBlock<float>& audioBlock)
+{
+    jassert(audioBlock.getNumChannels() <= channelStates.size());
+
+    const int numChannels = juce::jmin(static_cast<int>(audioBlock.getNumChannels()), static_cast<int>(channelStates.size()));
+    const int numSamples = static_cast<int>(audioBlock.getNumSamples());
+
+    // Filter up to the next sub-block boundary, then close the sub-block
+    for (int offset = 0; offset < numSamples;)
+    {
+        const int chunk = juce::jmin(numSamples - offset, subBlockLength - subBlockPosition);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            subBlockEnergy += filterChannel(channelStates[static_cast<size_t>(channel)],
+                                            audioBlock.getChannelPointer(static_cast<size_t>(channel)) + offset,
+                                            chunk);
+
+        offset += chunk;
+        subBlockPosition += chunk;
+
+        if (subBlockPosition == subBlockLength)
+            finishSubBlock();
+    }
+}
+
+void LoudnessMeter::releaseResources()
+{
+    channelStates.clear();
+}
+
+void LoudnessMeter::reset()
+{
+    for (auto& state : channelStates)
+        state = ChannelState();
+
+    subBlockPosition = 0;
+    subBlockEnergy = 0.0;
+    subBlockEnergies.fill(0.0);
+    subBlockIndex = 0;
+    numSubBlocks = 0;
+
+    momentaryHistogram.clear();
+    shortTermHistogram.clear();
+
+    momentaryLoudness = silenceLufs;
+    shortTermLoudness = silenceLufs;
+    integratedLoudness = silenceLufs;
+    loudnessRange = 0.0f;
+}
+
+//==============================================================================
+void LoudnessMeter::updateFilters(double sampleRate)
+{
+    // BS.1770 pre-filter (high shelf) and RLB high pass, re-derived for any
+    // sample rate; at 48 kHz these reproduce the coefficients in the standard
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+}
+
+double LoudnessMeter::filterChannel(ChannelState& state, const float* samples, int numSamples) const
+{
+    double s1 = state.shelf1, s2 = state.shelf2;
+    double h1 = state.highPass1, h2 = state.highPass2;
+    double sumOfSquares = 0.0;
+
+    // Two transposed direct form II biquads in series
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double x = samples[i];
+
+        const double y = shelf.b0 * x + s1;
+        s1 = shelf.b1 * x - shelf.a1 * y + s2;
+        s2 = shelf.b2 * x - shelf.a2 * y;
+
+        const double z = highPass.b0 * y + h1;
+        h1 = highPass.b1 * y - highPass.a1 * z + h2;
+        h2 = highPass.b2 * y - highPass.a2 * z;
+
+        sumOfSquares += z * z;
+    }
+
+    // Keep the decaying tails of silence out of the denormal range
+    auto flush = [](double v) { return std::abs(v) < 1.0e-20 ? 0.0 : v; };
+    state.shelf1 = flush(s1);
+    state.shelf2 = flush(s2);
+    state.highPass1 = flush(h1);
+    state.highPass2 = flush(h2);
+
+    return sumOfSquares;
+}
+
+void LoudnessMeter::finishSubBlock()
+{
+    subBlockEnergies[static_cast<size_t>(subBlockIndex)] = subBlockEnergy / subBlockLength;
+    subBlockIndex = (subBlockIndex + 1) % shortTermSubBlocks;
+    numSubBlocks = juce::jmin(numSubBlocks + 1, shortTermSubBlocks);
+
+    subBlockPosition = 0;
+    subBlockEnergy = 0.0;
+
+    // 400 ms gating blocks overlap by 75%, so one completes every sub-block
+    if (numSubBlocks >= momentarySubBlocks)
+    {
+        const double energy = getRecentEnergy(momentarySubBlocks);
+        momentaryLoudness = energyToLoudness(energy);
+
+        if (momentaryLoudness >= GatingHistogram::minimumLufs)
+            momentaryHistogram.add(momentaryLoudness, energy);
+
+        updateIntegratedLoudness();
+    }
+
+    if (numSubBlocks >= shortTermSubBlocks)
+    {
+        const double energy = getRecentEnergy(shortTermSubBlocks);
+        shortTermLoudness = energyToLoudness(energy);
+
+        if (shortTermLoudness >= GatingHistogram::minimumLufs)
+            shortTermHistogram.add(shortTermLoudness, energy);
+
+        updateLoudnessRange();
+    }
+}
+
+double LoudnessMeter::getRecentEnergy(int numBlocks) const
+{
+    double sum = 0.0;
+
+    for (int i = 1; i <= numBlocks; ++i)
+        sum += subBlockEnergies[static_cast<size_t>((subBlockIndex - i + shortTermSubBlocks) % shortTermSubBlocks)];
+
+    return sum / numBlocks;
+}
+
+void LoudnessMeter::updateIntegratedLoudness()
+{
+    // BS.1770: absolute gate at -70 LUFS (the histogram floor), then a
+    // relative gate 10 LU below the loudness of the absolute-gated blocks
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (int bin = 0; bin < GatingHistogram::numBins; ++bin)
+    {
+        count += momentaryHistogram.counts[static_cast<size_t>(bin)];
+        energy += momentaryHistogram.energies[static_cast<size_t>(bin)];
+    }
+
+    if (count == 0)
+    {
+        integratedLoudness = silenceLufs;
+        return;
+    }
+
+    const int firstBin = GatingHistogram::getBin(energyToLoudness(energy / static_cast<double>(count)) - 10.0f);
+
+    count = 0;
+    energy = 0.0;
+
+    for (int bin = firstBin; bin < GatingHistogram::numBins; ++bin)
+    {
+        count += momentaryHistogram.counts[static_cast<size_t>(bin)];
+        energy += momentaryHistogram.energies[static_cast<size_t>(bin)];
+    }
+
+    integratedLoudness = count > 0 ? energyToLoudness(energy / static_cast<double>(count)) : silenceLufs;
+}
+
+void LoudnessMeter::updateLoudnessRange()
+{
+    // EBU Tech 3342: short-term values gated at -70 LUFS and 20 LU below
+    // their mean, range = 95th - 10th percentile
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (int bin = 0; bin < GatingHistogram::numBins; ++bin)
+    {
+        count += shortTermHistogram.counts[static_cast<size_t>(bin)];
+        energy += shortTermHistogram.energies[static_cast<size_t>(bin)];
+    }
+
+    if (count == 0)
+    {
+        loudnessRange = 0.0f;
+        return;
+    }
+
+    const int firstBin = GatingHistogram::getBin(energyToLoudness(energy / static_cast<double>(count)) - 20.0f);
+
+    juce::uint64 gatedCount = 0;
+    for (int bin = firstBin; bin < GatingHistogram::numBins; ++bin)
+        gatedCount += shortTermHistogram.counts[static_cast<size_t>(bin)];
+
+    if (gatedCount == 0)
+    {
+        loudnessRange = 0.0f;
+        return;
+    }
+
+    const auto lowTarget = juce::jmax((juce::uint64) 1, static_cast<juce::uint64>(std::ceil(0.10 * static_cast<double>(gatedCount))));
+    const auto highTarget = juce::jmax((juce::uint64) 1, static_cast<juce::uint64>(std::ceil(0.95 * static_cast<double>(gatedCount))));
+
+    int lowBin = firstBin, highBin = firstBin;
+    juce::uint64 cumulative = 0;
+
+    for (int bin = firstBin; bin < GatingHistogram::numBins; ++bin)
+    {
+        const auto previous = cumulative;
+        cumulative += shortTermHistogram.counts[static_cast<size_t>(bin)];
+
+        if (previous < lowTarget && cumulative >= lowTarget)
+            lowBin = bin;
+
+        if (previous < highTarget && cumulative >= highTarget)
+        {
+            highBin = bin;
+            break;
+        }
+    }
+
+    loudnessRange = GatingHistogram::getBinCentre(highBin) - GatingHistogram::getBinCentre(lowBin);
+}
+
+float LoudnessMeter::energyToLoudness(double energy)
+{
+    if (energy <= 0.0)
+        return silenceLufs;
+
+    return juce::jmax(silenceLufs, static_cast<float>(-0.691 + 10.0 * std::log10(energy)));
+}
+
+//==============================================================================
+void LoudnessMeter::GatingHistogram::clear()
+{
+    counts.fill(0);
+    energies.fill(0.0);
+}
+
+void LoudnessMeter::GatingHistogram::add(float loudness, double energy)
+{
+    const auto bin = static_cast<size_t>(getBin(loudness));
+    ++counts[bin];
+    energies[bin] += energy;
+}
+
+int LoudnessMeter::GatingHistogram::getBin(float loudness)
+{
+    const int bin = static_cast<int>(std::floor((loudness - minimumLufs) / binWidth));
+    return juce::jlimit(0, numBins - 1, bin);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+// ITU-R BS.1770-4 / EBU R128 loudness meter.
+//
+// Audio is K-weighted (high shelf + RLB high pass) and its energy summed into
+// 100 ms sub-blocks. Momentary (400 ms) and short-term (3 s) loudness are
+// sliding sums over the last 4 and 30 sub-blocks. Integrated loudness and
+// loudness range (EBU Tech 3342) are gated from fixed 0.1 LU histograms, so
+// the meter's memory stays constant however long it runs.
+//
+// All channels are weighted 1.0 (mono/stereo material). Not allocating or
+// locking in processBlock, so it is safe on the audio thread.
+class LoudnessMeter
+{
+public:
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    void prepareToPlay(double sampleRate, int numChannels);
+    void processBlock(const juce::dsp::AudioBlock<float>& audioBlock);
+    void releaseResources();
+
+    // Clears the integrated measurement and loudness range
+    void reset();
+
+    // Results (LUFS / LU), updated every 100 ms of audio.
+    // Loudness reads silenceLufs until enough audio has been measured.
+    float getMomentaryLoudness() const { return momentaryLoudness; }
+    float getShortTermLoudness() const { return shortTermLoudness; }
+    float getIntegratedLoudness() const { return integratedLoudness; }
+    float getLoudnessRange() const { return loudnessRange; }
+
+    static constexpr float silenceLufs = -100.0f;
+
+private:
+    //==============================================================================
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct ChannelState
+    {
+        double shelf1 = 0.0, shelf2 = 0.0;
+        double highPass1 = 0.0, highPass2 = 0.0;
+    };
+
+    // Per-bin block count and summed energy between -70 LUFS (the absolute
+    // gate) and +5 LUFS; anything louder lands in the top bin
+    struct GatingHistogram
+    {
+        static constexpr float minimumLufs = -70.0f;
+        static constexpr float binWidth = 0.1f;
+        static constexpr int numBins = 750;
+
+        std::array<juce::uint32, numBins> counts;
+        std::array<double, numBins> energies;
+
+        void clear();
+        void add(float loudness, double energy);
+        static int getBin(float loudness);
+        static float getBinCentre(int bin) { return minimumLufs + (static_cast<float>(bin) + 0.5f) * binWidth; }
+    };
+
+    static constexpr int momentarySubBlocks = 4;    // 400 ms
+    static constexpr int shortTermSubBlocks = 30;   // 3 s
+
+    Biquad shelf, highPass;
+    std::vector<ChannelState> channelStates;
+
+    int subBlockLength = 4800;
+    int subBlockPosition = 0;
+    double subBlockEnergy = 0.0;
+
+    std::array<double, shortTermSubBlocks> subBlockEnergies {};
+    int subBlockIndex = 0;
+    int numSubBlocks = 0;
+
+    GatingHistogram momentaryHistogram;   // integrated loudness
+    GatingHistogram shortTermHistogram;   // loudness range
+
+    float momentaryLoudness = silenceLufs;
+    float shortTermLoudness = silenceLufs;
+    float integratedLoudness = silenceLufs;
+    float loudnessRange = 0.0f;
+
+    void updateFilters(double sampleRate);
+    double filterChannel(ChannelState& state, const float* samples, int numSamples) const;
+    void finishSubBlock();
+    double getRecentEnergy(int numBlocks) const;
+    void updateIntegratedLoudness();
+    void updateLoudnessRange();
+
+    static float energyToLoudness(double energy);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
@@ -100,6 +100,15 @@ public:
             JUCEApplication::getInstance()->systemRequestedQuit();
         }
 
+        void minimisationStateChanged (bool isNowMinimised) override
+        {
+            DocumentWindow::minimisationStateChanged (isNowMinimised);
+
+            // Stop drawing meters nobody can see, and catch up when restored
+            if (auto* content = dynamic_cast<MainComponent*> (getContentComponent()))
+                content->updateRefreshRate();
+        }
+
     private:
         void setupWindowBounds()
         {
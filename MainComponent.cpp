@@ -1,9 +1,130 @@
 #include "MainComponent.h"
+#include "DummyAudioDevice.h"
+
+namespace
+{
+    // --dummy-device selects the hardware-free device; --dummy-speed (multiple
+    // of realtime, 0 = as fast as possible), --dummy-input and --dummy-output
+    // configure it
+    DummyAudioIODevice::Options getDummyDeviceOptions(const juce::ArgumentList& args)
+    {
+        DummyAudioIODevice::Options options;
+        const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+        if (args.containsOption("--dummy-speed"))
+            options.speed = juce::jmax(0.0, args.getValueForOption("--dummy-speed").getDoubleValue());
+
+        if (const auto input = args.getValueForOption("--dummy-input"); input.isNotEmpty())
+            options.inputFile = cwd.getChildFile(input.unquoted());
+
+        if (const auto output = args.getValueForOption("--dummy-output"); output.isNotEmpty())
+            options.outputFile = cwd.getChildFile(output.unquoted());
+
+        return options;
+    }
+
+    // Hardcoded presets, used when no .preset file of that name exists;
+    // unknown names leave the values alone
+    void setBuiltInPreset(const juce::String& presetName, PresetSettings& preset)
+    {
+        if (presetName == "Default")
+        {
+            preset.inputGainDb = 0.0f;
+            preset.outputGainDb = 0.0f;
+            preset.gateThreshold = -60.0f;
+            preset.gateRatio = 10.0f;
+            preset.gateAttack = 1.0f;
+            preset.gateRelease = 100.0f;
+            preset.threshold = -18.0f;
+            preset.ratio = 3.0f;
+            preset.attack = 1.0f;
+            preset.release = 30.0f;
+            preset.ceiling = -1.0f;
+            preset.lookahead = 3.0f;
+            preset.limiterRelease = 300.0f;
+            preset.knee = 2.0f;
+            preset.makeupGain = 0.0f;
+        }
+        else if (presetName == "Podcast")
+        {
+            preset.inputGainDb = 1.6f;
+            preset.outputGainDb = -1.9f;
+            preset.gateThreshold = -50.0f;
+            preset.gateRatio = 15.0f;
+            preset.gateAttack = 2.0f;
+            preset.gateRelease = 150.0f;
+            preset.threshold = -24.0f;
+            preset.ratio = 4.0f;
+            preset.attack = 2.0f;
+            preset.release = 50.0f;
+            preset.ceiling = -2.0f;
+            preset.lookahead = 2.0f;
+            preset.limiterRelease = 200.0f;
+            preset.knee = 3.0f;
+            preset.makeupGain = 2.0f;
+        }
+        else if (presetName == "Streaming")
+        {
+            preset.inputGainDb = 3.5f;
+            preset.outputGainDb = -3.1f;
+            preset.gateThreshold = -45.0f;
+            preset.gateRatio = 20.0f;
+            preset.gateAttack = 1.5f;
+            preset.gateRelease = 120.0f;
+            preset.threshold = -20.0f;
+            preset.ratio = 6.0f;
+            preset.attack = 1.5f;
+            preset.release = 40.0f;
+            preset.ceiling = -1.5f;
+            preset.lookahead = 4.0f;
+            preset.limiterRelease = 200.0f;
+            preset.knee = 2.5f;
+            preset.makeupGain = 3.0f;
+        }
+        else if (presetName == "VoiceOver")
+        {
+            preset.inputGainDb = 5.1f;
+            preset.outputGainDb = -4.4f;
+            preset.gateThreshold = -40.0f;
+            preset.gateRatio = 25.0f;
+            preset.gateAttack = 0.5f;
+            preset.gateRelease = 80.0f;
+            preset.threshold = -16.0f;
+            preset.ratio = 8.0f;
+            preset.attack = 0.5f;
+            preset.release = 25.0f;
+            preset.ceiling = -0.5f;
+            preset.lookahead = 5.0f;
+            preset.limiterRelease = 150.0f;
+            preset.knee = 1.5f;
+            preset.makeupGain = 4.0f;
+        }
+        else if (presetName == "SlammedUp")
+        {
+            preset.inputGainDb = 20.0f;
+            preset.outputGainDb = 0.0f;
+            preset.gateThreshold = -44.0f;  // NoiseGate Threshold=-40.0
+            preset.gateRatio = 21.0f;  // NoiseGate Ratio=21.0
+            preset.gateAttack = 0.1f;  // NoiseGate Attack=0.1
+            preset.gateRelease = 400.0f;  // NoiseGate Release=400.0
+            preset.threshold = -18.0f;  // Compressor Threshold=-18.0
+            preset.ratio = 3.6f;  // Compressor Ratio=3.0
+            preset.attack = 0.2f;  // Compressor Attack=0.5
+            preset.release = 175.0f;  // Compressor Release=20.0
+            preset.ceiling = -1.5f;  // Limiter Ceiling=-1.66
+            preset.lookahead = 5.0f;  // Limiter Lookahead=5.0
+            preset.limiterRelease = 100.0f;
+            preset.knee = 1.5f;  // Compressor Knee=1.5
+            preset.makeupGain = 4.0f;  // MakeupGain=4.0
+        }
+    }
+}
 
 // AudioMeter implementation
 AudioMeter::AudioMeter(const juce::String& name) : meterName(name)
 {
     lastUpdateTime = juce::Time::getMillisecondCounterHiRes();
+    setOpaque(true);
 }
 
 void AudioMeter::setValue(float newValue)
@@ -36,84 +157,212 @@ void AudioMeter::setValue(float newValue)
             peakValue = currentValue;
     }
 
-    repaint();
+    // Invalidate only the rows between the old and new bar top, and the old
+    // and new peak line
+    const int newLevelTop = getLevelY(currentValue);
+    const int newPeakY = peakValue > 0.0f ? getLevelY(peakValue) : -1;
+
+    if (newLevelTop != levelTop)
+    {
+        repaint(0, juce::jmin(levelTop, newLevelTop), getWidth(), std::abs(newLevelTop - levelTop));
+        levelTop = newLevelTop;
+    }
+
+    if (newPeakY != peakY)
+    {
+        if (peakY >= 0)
+            repaint(getPeakLineArea(peakY));
+
+        if (newPeakY >= 0)
+            repaint(getPeakLineArea(newPeakY));
+
+        peakY = newPeakY;
+    }
 }
 
-void AudioMeter::paint(juce::Graphics& g)
+int AudioMeter::getLevelY(float value) const
+{
+    const auto bar = getBarArea();
+    return bar.getBottom() - juce::roundToInt(static_cast<float>(bar.getHeight()) * juce::jlimit(0.0f, 1.0f, value));
+}
+
+void AudioMeter::renderImages(float scale)
 {
-    auto bounds = getLocalBounds().toFloat();
+    imageScale = scale;
 
-    // Background
-    g.setColour(juce::Colours::black);
-    g.fillRect(bounds);
+    const int width = juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * scale));
+    const int height = juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * scale));
 
-    // Border
-    g.setColour(juce::Colours::white);
-    g.drawRect(bounds, 1.0f);
+    for (const bool lit : { false, true })
+    {
+        juce::Image image(juce::Image::RGB, width, height, false);
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(scale));
 
-    // Calculate meter height based on value
-    float meterHeight = bounds.getHeight() * currentValue;
-    float peakHeight = bounds.getHeight() * peakValue;
+        auto bounds = getLocalBounds().toFloat();
 
-    // Draw meter segments with proper colors
-    auto meterBounds = bounds.reduced(2.0f);
+        // Background
+        g.setColour(juce::Colours::black);
+        g.fillRect(bounds);
 
-    // Green zone (0 to -20 dB)
-    g.setColour(juce::Colours::green);
-    float greenHeight = meterBounds.getHeight() * 0.63f; // -20 dB = 0.1 in linear
-    if (meterHeight > 0)
-    {
-        float greenMeterHeight = juce::jmin(meterHeight, greenHeight);
-        g.fillRect(meterBounds.removeFromBottom(greenMeterHeight));
-    }
+        // Border
+        g.setColour(juce::Colours::white);
+        g.drawRect(bounds, 1.0f);
 
-    // Yellow zone (-20 to -6 dB)
-    if (meterHeight > greenHeight)
-    {
-        g.setColour(juce::Colours::yellow);
-        float yellowHeight = meterBounds.getHeight() * 0.25f; // -6 dB = 0.5 in linear
-        float yellowMeterHeight = juce::jmin(meterHeight - greenHeight, yellowHeight);
-        if (yellowMeterHeight > 0)
+        if (lit)
         {
-            g.fillRect(meterBounds.removeFromBottom(yellowMeterHeight));
+            // Green to -20 dB (0.1 linear), yellow to -6 dB (0.5 linear), red above
+            auto bar = getBarArea().toFloat();
+            const auto barHeight = bar.getHeight();
+
+            g.setColour(juce::Colours::green);
+            g.fillRect(bar.removeFromBottom(barHeight * 0.63f));
+            g.setColour(juce::Colours::yellow);
+            g.fillRect(bar.removeFromBottom(barHeight * 0.25f));
+            g.setColour(juce::Colours::red);
+            g.fillRect(bar);
         }
+
+        // Label
+        g.setColour(juce::Colours::white);
+        g.setFont(12.0f);
+        g.drawText(meterName, bounds.removeFromTop(20), juce::Justification::centred);
+
+        (lit ? litImage : unlitImage) = image;
     }
+}
+
+void AudioMeter::paint(juce::Graphics& g)
+{
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (litImage.isNull() || scale != imageScale)
+        renderImages(scale);
+
+    // Unlit above the bar top, lit below; the clip is usually a few rows
+    const auto toComponent = juce::AffineTransform::scale(1.0f / imageScale);
 
-    // Red zone (-6 to 0 dB)
-    if (meterHeight > greenHeight + (bounds.getHeight() * 0.25f))
     {
-        g.setColour(juce::Colours::red);
-        float redMeterHeight = meterHeight - greenHeight - (bounds.getHeight() * 0.25f);
-        if (redMeterHeight > 0)
-        {
-            g.fillRect(meterBounds.removeFromBottom(redMeterHeight));
-        }
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(0, 0, getWidth(), levelTop);
+        g.drawImageTransformed(unlitImage, toComponent);
+    }
+
+    {
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(0, levelTop, getWidth(), getHeight() - levelTop);
+        g.drawImageTransformed(litImage, toComponent);
     }
 
     // Draw peak indicator
-    if (peakValue > 0)
+    if (peakY >= 0)
     {
         g.setColour(juce::Colours::white);
-        float peakY = bounds.getBottom() - (bounds.getHeight() * peakValue);
-        g.drawLine(bounds.getX(), peakY, bounds.getRight(), peakY, 2.0f);
+        g.fillRect(getPeakLineArea(peakY));
     }
-
-    // Draw label
-    g.setColour(juce::Colours::white);
-    g.setFont(12.0f);
-    g.drawText(meterName, bounds.removeFromTop(20), juce::Justification::centred);
 }
 
 void AudioMeter::resized()
 {
-    // No special resizing needed
+    // New geometry: re-render the images and re-quantise what is shown
+    litImage = {};
+    unlitImage = {};
+    levelTop = getLevelY(currentValue);
+    peakY = peakValue > 0.0f ? getLevelY(peakValue) : -1;
+}
+
+// HistoryView implementation
+HistoryView::HistoryView(const MeterHistory& historyToShow)
+    : history(historyToShow),
+      visibleSeconds(historyToShow.getHistorySeconds())
+{
+    setOpaque(true);
+}
+
+void HistoryView::resized()
+{
+    columns.resize(static_cast<size_t>(juce::jmax(0, getWidth())));
+}
+
+void HistoryView::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    // Zoom by a constant factor per notch
+    visibleSeconds = juce::jlimit(1.0, history.getHistorySeconds(), visibleSeconds * std::pow(0.5, wheel.deltaY * 2.0));
+    repaint();
+}
+
+void HistoryView::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    const auto height = static_cast<float>(getHeight());
+    const auto numColumns = static_cast<int>(columns.size());
+    history.getColumns(columns.data(), numColumns, visibleSeconds);
+
+    // Output level in dBFS from the bottom (-60..0), reduction in dB from the top (0..20)
+    auto levelToY = [height](float gain)
+    {
+        return height * juce::Decibels::gainToDecibels(gain, -60.0f) / -60.0f;
+    };
+
+    auto reductionToY = [height](float reductionDb)
+    {
+        return height * juce::jlimit(0.0f, 1.0f, reductionDb / 20.0f);
+    };
+
+    for (int x = 0; x < numColumns; ++x)
+    {
+        const auto& column = columns[static_cast<size_t>(x)];
+
+        if (column.isEmpty())
+            continue;
+
+        // Loudest block faint, quietest block solid
+        const auto loudestY = levelToY(column.outputPeak.max);
+        const auto quietestY = juce::jmax(loudestY, levelToY(column.outputPeak.min));
+        g.setColour(juce::Colours::green.withAlpha(0.5f));
+        g.fillRect(static_cast<float>(x), loudestY, 1.0f, quietestY - loudestY);
+        g.setColour(juce::Colours::green);
+        g.fillRect(static_cast<float>(x), quietestY, 1.0f, height - quietestY);
+
+        // Compressor and limiter reduction hanging from the top, same scheme
+        g.setColour(juce::Colours::red.withAlpha(0.5f));
+        g.fillRect(static_cast<float>(x), 0.0f, 1.0f, reductionToY(column.gainReductionDb.max));
+        g.setColour(juce::Colours::red);
+        g.fillRect(static_cast<float>(x), 0.0f, 1.0f, reductionToY(column.gainReductionDb.min));
+
+        // Gate closing: a strip along the bottom, brighter the deeper it cut
+        if (column.gateReductionDb.max > 0.5f)
+        {
+            g.setColour(juce::Colours::dodgerblue.withAlpha(juce::jlimit(0.3f, 1.0f, column.gateReductionDb.max / 40.0f)));
+            g.fillRect(static_cast<float>(x), height - 4.0f, 1.0f, 4.0f);
+        }
+    }
+
+    g.setColour(juce::Colours::white);
+    g.setFont(12.0f);
+    g.drawText(juce::String(visibleSeconds, visibleSeconds < 10.0 ? 1 : 0) + " s",
+               getLocalBounds().reduced(4, 2), juce::Justification::bottomRight);
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(getLocalBounds());
 }
 
 MainComponent::MainComponent()
 {
+    const juce::ArgumentList args("AudioProcessor", juce::JUCEApplicationBase::getCommandLineParameterArray());
+
+    // Create the built-in driver types first: AudioDeviceManager only adds
+    // them while its list is empty
+    deviceManager.getAvailableDeviceTypes();
+    deviceManager.addAudioDeviceType(std::make_unique<DummyAudioIODeviceType>(getDummyDeviceOptions(args)));
+
     // 1 input channel, 2 output channels (JUCE will adapt to device layout)
     deviceManager.initialise (1, 2, nullptr, true);
 
+    if (args.containsOption("--dummy-device"))
+        deviceManager.setCurrentAudioDeviceType(DummyAudioIODeviceType::typeName, true);
+
     // Create custom meters
     inputMeter = std::make_unique<AudioMeter>("Input");
     outputMeter = std::make_unique<AudioMeter>("Output");
@@ -123,6 +372,7 @@ MainComponent::MainComponent()
     addAndMakeVisible(inputDeviceBox);
     addAndMakeVisible(outputDeviceBox);
     addAndMakeVisible(enableButton);
+    addAndMakeVisible(nativeJackButton);
 
     addAndMakeVisible(inputGainSlider);
     addAndMakeVisible(outputGainSlider);
@@ -164,6 +414,11 @@ MainComponent::MainComponent()
     addAndMakeVisible(inputMeter.get());
     addAndMakeVisible(outputMeter.get());
     addAndMakeVisible(gainReductionMeter.get());
+    addAndMakeVisible(historyView);
+    addAndMakeVisible(loudnessLabel);
+    addAndMakeVisible(latencyLabel);
+    addAndMakeVisible(dspLoadLabel);
+    addAndMakeVisible(profileButton);
 
     // Setup sliders and labels
     setupSliders();
@@ -189,14 +444,39 @@ MainComponent::MainComponent()
     deletePresetButton.onClick = [this]{ handleDeletePresetClick(); };
     presetBox.onChange = [this]{ loadPreset(presetBox.getText()); };
 
+    // Processed audio is mirrored to the virtual device while processing is on
+    engine.setVirtualDevice(&virtualDevice);
+    nativeJackButton.setEnabled(virtualDevice.isAvailable());
+
+    // Callback profiling is cheap enough to leave on; the switch is for A/B-ing that claim
+    profileButton.setToggleState(true, juce::dontSendNotification);
+    profileButton.onClick = [this]
+    {
+        const bool enabled = profileButton.getToggleState();
+        engine.getProfiler().setEnabled(enabled);
+
+        if (auto* jackProfiler = virtualDevice.getProfiler())
+            jackProfiler->setEnabled(enabled);
+    };
+
+    // A JACK period or rate change re-prepares the engine when JACK drives it;
+    // the new DSP state is swapped in on the JACK thread at a period boundary
+    virtualDevice.setFormatChangedCallback([this](double sampleRate, int bufferSize)
+    {
+        if (virtualDevice.isNativeMode())
+            engine.prepareToPlay(sampleRate, bufferSize);
+    });
+
     refreshDeviceLists();
-    startTimerHz(30); // meter refresh
+    startTimerHz(visibleRefreshHz); // meter refresh; slowed down while hidden
 }
 
 MainComponent::~MainComponent()
 {
     if (processingOn)
-        deviceManager.removeAudioCallback(&engine);
+        stopProcessing();
+    
+    virtualDevice.setFormatChangedCallback(nullptr);
     
     // Reset look and feel to prevent dangling pointers
     inputDeviceBox.setLookAndFeel(nullptr);
@@ -237,7 +517,9 @@ void MainComponent::resized()
     inputDeviceBox.setBounds(deviceArea.removeFromLeft(deviceArea.getWidth() / 2 - 5).removeFromTop(comboBoxHeight));
     outputDeviceBox.setBounds(deviceArea.removeFromRight(deviceArea.getWidth() / 2 - 5).removeFromTop(comboBoxHeight));
     deviceArea.removeFromTop(10); // add space before button
-    enableButton.setBounds(deviceArea.removeFromTop(buttonHeight));
+    auto enableArea = deviceArea.removeFromTop(buttonHeight);
+    nativeJackButton.setBounds(enableArea.removeFromRight(140));
+    enableButton.setBounds(enableArea);
 
     // Meters area (right side)
     auto metersArea = bounds.removeFromRight(80);
@@ -247,11 +529,19 @@ void MainComponent::resized()
     outputMeter->setBounds(metersArea.removeFromTop(meterHeight));
     metersArea.removeFromTop(10);
     gainReductionMeter->setBounds(metersArea.removeFromTop(meterHeight));
+    metersArea.removeFromTop(10);
+    loudnessLabel.setBounds(metersArea.removeFromTop(juce::jmax(96, labelHeight * 6)));
+    latencyLabel.setBounds(metersArea.removeFromTop(juce::jmax(48, labelHeight * 3)));
+    dspLoadLabel.setBounds(metersArea.removeFromTop(juce::jmax(96, labelHeight * 6)));
+    profileButton.setBounds(metersArea.removeFromTop(24));
 
     // Preset area - dynamic height for 3 buttons
     const int presetAreaHeight = comboBoxHeight + (buttonHeight * 3) + 15; // padding between buttons
     auto presetArea = bounds.removeFromTop(presetAreaHeight);
-    presetBox.setBounds(presetArea.removeFromLeft(presetArea.getWidth() / 2 - 5).removeFromTop(comboBoxHeight));
+    auto historyArea = presetArea.removeFromLeft(presetArea.getWidth() / 2 - 5);
+    presetBox.setBounds(historyArea.removeFromTop(comboBoxHeight));
+    historyArea.removeFromTop(5);
+    historyView.setBounds(historyArea);
     auto buttonArea = presetArea.removeFromRight(presetArea.getWidth() / 2 - 5);
     savePresetButton.setBounds(buttonArea.removeFromTop(buttonHeight));
     buttonArea.removeFromTop(5);
@@ -337,8 +627,8 @@ void MainComponent::setupSliders()
     };
 
     // Input/Output gains
-    setupVerticalSlider(inputGainSlider, 0.0, 10.0, 1.0, [this]{ updateEngineParameters(); });
-    setupVerticalSlider(outputGainSlider, 0.0, 10.0, 1.0, [this]{ updateEngineParameters(); });
+    setupVerticalSlider(inputGainSlider, -20.0, 20.0, 0.0, [this]{ updateEngineParameters(); });
+    setupVerticalSlider(outputGainSlider, -20.0, 20.0, 0.0, [this]{ updateEngineParameters(); });
 
     // Noise Gate controls
     setupVerticalSlider(gateThresholdSlider, -80.0, 0.0, -60.0, [this]{ updateEngineParameters(); });
@@ -404,6 +694,16 @@ void MainComponent::setupLabels()
 
     makeupGainLabel.setText("Makeup", juce::dontSendNotification);
     makeupGainLabel.setJustificationType(juce::Justification::centred);
+
+    loudnessLabel.setJustificationType(juce::Justification::centredLeft);
+    loudnessLabel.setFont(juce::Font(12.0f));
+
+    latencyLabel.setJustificationType(juce::Justification::centredLeft);
+    latencyLabel.setFont(juce::Font(12.0f));
+
+    dspLoadLabel.setJustificationType(juce::Justification::centredLeft);
+    dspLoadLabel.setFont(juce::Font(12.0f));
+    dspLoadLabel.setText("DSP\n--", juce::dontSendNotification);
 }
 
 void MainComponent::setupPresets()
@@ -413,130 +713,70 @@ void MainComponent::setupPresets()
 
 void MainComponent::updateEngineParameters()
 {
-    // Update AudioEngine parameters
-    engine.inputGain.store(inputGainSlider.getValue());
-    engine.outputGain.store(outputGainSlider.getValue());
-
-    // Update Noise Gate parameters
-    engine.gateThreshold.store(gateThresholdSlider.getValue());
-    engine.gateRatio.store(gateRatioSlider.getValue());
-    engine.gateAttack.store(gateAttackSlider.getValue());
-    engine.gateRelease.store(gateReleaseSlider.getValue());
-
-    // Update Compressor parameters
-    engine.threshDb.store(thresholdSlider.getValue());
-    engine.ratio.store(ratioSlider.getValue());
-    engine.ceilingDb.store(ceilingSlider.getValue());
-
-    // Update Compressor and Limiter parameters
-    compressor.setThreshold(thresholdSlider.getValue());
-    compressor.setRatio(ratioSlider.getValue());
-    compressor.setAttack(attackSlider.getValue());
-    compressor.setRelease(releaseSlider.getValue());
-    compressor.setKnee(kneeSlider.getValue());
-    compressor.setMakeupGain(makeupGainSlider.getValue());
-
-    limiter.setCeiling(ceilingSlider.getValue());
-    limiter.setLookahead(lookaheadSlider.getValue());
-    limiter.setRelease(releaseSlider.getValue());
+    // Gather the whole parameter set, then publish it to the engine in one go
+    engineSettings.inputGainDb = static_cast<float>(inputGainSlider.getValue());
+    engineSettings.outputGainDb = static_cast<float>(outputGainSlider.getValue());
+
+    // Noise Gate parameters
+    engineSettings.gateThreshold = static_cast<float>(gateThresholdSlider.getValue());
+    engineSettings.gateRatio = static_cast<float>(gateRatioSlider.getValue());
+    engineSettings.gateAttack = static_cast<float>(gateAttackSlider.getValue());
+    engineSettings.gateRelease = static_cast<float>(gateReleaseSlider.getValue());
+
+    // Compressor parameters
+    engineSettings.threshold = static_cast<float>(thresholdSlider.getValue());
+    engineSettings.ratio = static_cast<float>(ratioSlider.getValue());
+    engineSettings.attack = static_cast<float>(attackSlider.getValue());
+    engineSettings.release = static_cast<float>(releaseSlider.getValue());
+    engineSettings.knee = static_cast<float>(kneeSlider.getValue());
+    engineSettings.makeupGain = static_cast<float>(makeupGainSlider.getValue());
+
+    // Limiter parameters (release has no slider and comes from the preset)
+    engineSettings.ceiling = static_cast<float>(ceilingSlider.getValue());
+    engineSettings.lookahead = static_cast<float>(lookaheadSlider.getValue());
+
+    engine.setParameters(engineSettings);
 }
 
 void MainComponent::loadPreset(const juce::String& presetName)
 {
+    // Keys a preset leaves out keep their current values; sections without
+    // an Enabled key stay enabled and auto gain is opt-in
+    auto preset = engineSettings;
+    preset.autoGainEnabled = false;
+    preset.gateEnabled = true;
+    preset.compressorEnabled = true;
+    preset.limiterEnabled = true;
+
     // First try to load from file, if that fails use hardcoded values
-    if (loadPresetFromFile(presetName))
-    {
-        updateEngineParameters();
-        return;
-    }
-    
-    // Fallback to hardcoded presets
-    if (presetName == "Default")
-    {
-        inputGainSlider.setValue(1.0);
-        outputGainSlider.setValue(1.0);
-        gateThresholdSlider.setValue(-60.0);
-        gateRatioSlider.setValue(10.0);
-        gateAttackSlider.setValue(1.0);
-        gateReleaseSlider.setValue(100.0);
-        thresholdSlider.setValue(-18.0);
-        ratioSlider.setValue(3.0);
-        attackSlider.setValue(1.0);
-        releaseSlider.setValue(30.0);
-        ceilingSlider.setValue(-1.0);
-        lookaheadSlider.setValue(3.0);
-        kneeSlider.setValue(2.0);
-        makeupGainSlider.setValue(0.0);
-    }
-    else if (presetName == "Podcast")
-    {
-        inputGainSlider.setValue(1.2);
-        outputGainSlider.setValue(0.8);
-        gateThresholdSlider.setValue(-50.0);
-        gateRatioSlider.setValue(15.0);
-        gateAttackSlider.setValue(2.0);
-        gateReleaseSlider.setValue(150.0);
-        thresholdSlider.setValue(-24.0);
-        ratioSlider.setValue(4.0);
-        attackSlider.setValue(2.0);
-        releaseSlider.setValue(50.0);
-        ceilingSlider.setValue(-2.0);
-        lookaheadSlider.setValue(2.0);
-        kneeSlider.setValue(3.0);
-        makeupGainSlider.setValue(2.0);
-    }
-    else if (presetName == "Streaming")
-    {
-        inputGainSlider.setValue(1.5);
-        outputGainSlider.setValue(0.7);
-        gateThresholdSlider.setValue(-45.0);
-        gateRatioSlider.setValue(20.0);
-        gateAttackSlider.setValue(1.5);
-        gateReleaseSlider.setValue(120.0);
-        thresholdSlider.setValue(-20.0);
-        ratioSlider.setValue(6.0);
-        attackSlider.setValue(1.5);
-        releaseSlider.setValue(40.0);
-        ceilingSlider.setValue(-1.5);
-        lookaheadSlider.setValue(4.0);
-        kneeSlider.setValue(2.5);
-        makeupGainSlider.setValue(3.0);
-    }
-    else if (presetName == "VoiceOver")
-    {
-        inputGainSlider.setValue(1.8);
-        outputGainSlider.setValue(0.6);
-        gateThresholdSlider.setValue(-40.0);
-        gateRatioSlider.setValue(25.0);
-        gateAttackSlider.setValue(0.5);
-        gateReleaseSlider.setValue(80.0);
-        thresholdSlider.setValue(-16.0);
-        ratioSlider.setValue(8.0);
-        attackSlider.setValue(0.5);
-        releaseSlider.setValue(25.0);
-        ceilingSlider.setValue(-0.5);
-        lookaheadSlider.setValue(5.0);
-        kneeSlider.setValue(1.5);
-        makeupGainSlider.setValue(4.0);
-    }
-    else if (presetName == "SlammedUp")
-    {
-        inputGainSlider.setValue(10.0);  // Input Gain=10.0
-        outputGainSlider.setValue(1.0);  // Output Gain=0.0 but using 1.0 as base
-        gateThresholdSlider.setValue(-44.0);  // NoiseGate Threshold=-40.0
-        gateRatioSlider.setValue(21.0);  // NoiseGate Ratio=21.0
-        gateAttackSlider.setValue(0.1);  // NoiseGate Attack=0.1
-        gateReleaseSlider.setValue(400.0);  // NoiseGate Release=400.0
-        thresholdSlider.setValue(-18.0);  // Compressor Threshold=-18.0
-        ratioSlider.setValue(3.6);  // Compressor Ratio=3.0
-        attackSlider.setValue(0.2);  // Compressor Attack=0.5
-        releaseSlider.setValue(175.0);  // Compressor Release=20.0
-        ceilingSlider.setValue(-1.5);  // Limiter Ceiling=-1.66
-        lookaheadSlider.setValue(5.0);  // Limiter Lookahead=5.0
-        kneeSlider.setValue(1.5);  // Compressor Knee=1.5
-        makeupGainSlider.setValue(4.0);  // MakeupGain=4.0
-    }
+    if (!loadPresetFromFile(getPresetFile(presetName), preset))
+        setBuiltInPreset(presetName, preset);
+
+    applyPreset(preset);
+}
 
+void MainComponent::applyPreset(const PresetSettings& preset)
+{
+    // Without notifications, so the engine gets one snapshot with the whole
+    // preset instead of one per slider with old and new values mixed
+    inputGainSlider.setValue(preset.inputGainDb, juce::dontSendNotification);
+    outputGainSlider.setValue(preset.outputGainDb, juce::dontSendNotification);
+    gateThresholdSlider.setValue(preset.gateThreshold, juce::dontSendNotification);
+    gateRatioSlider.setValue(preset.gateRatio, juce::dontSendNotification);
+    gateAttackSlider.setValue(preset.gateAttack, juce::dontSendNotification);
+    gateReleaseSlider.setValue(preset.gateRelease, juce::dontSendNotification);
+    thresholdSlider.setValue(preset.threshold, juce::dontSendNotification);
+    ratioSlider.setValue(preset.ratio, juce::dontSendNotification);
+    attackSlider.setValue(preset.attack, juce::dontSendNotification);
+    releaseSlider.setValue(preset.release, juce::dontSendNotification);
+    ceilingSlider.setValue(preset.ceiling, juce::dontSendNotification);
+    lookaheadSlider.setValue(preset.lookahead, juce::dontSendNotification);
+    kneeSlider.setValue(preset.knee, juce::dontSendNotification);
+    makeupGainSlider.setValue(preset.makeupGain, juce::dontSendNotification);
+
+    // Switches, AGC settings and limiter release come from the preset, slider
+    // values as the sliders hold them after range snapping
+    engineSettings = preset;
     updateEngineParameters();
 }
 
@@ -558,10 +798,13 @@ void MainComponent::savePreset(const juce::String& presetName)
     
     presetContent += "[Input]\n";
     presetContent += "Gain=" + juce::String(inputGainSlider.getValue(), 2) + "\n";
+    presetContent += "AutoGain=" + juce::String(engineSettings.autoGainEnabled ? "true" : "false") + "\n";
+    presetContent += "TargetLUFS=" + juce::String(engineSettings.autoGainTarget, 2) + "\n";
+    presetContent += "MaxBoost=" + juce::String(engineSettings.autoGainMaxBoost, 2) + "\n";
     presetContent += "\n";
     
     presetContent += "[NoiseGate]\n";
-    presetContent += "Enabled=true\n";
+    presetContent += "Enabled=" + juce::String(engineSettings.gateEnabled ? "true" : "false") + "\n";
     presetContent += "Threshold=" + juce::String(gateThresholdSlider.getValue(), 2) + "\n";
     presetContent += "Ratio=" + juce::String(gateRatioSlider.getValue(), 2) + "\n";
     presetContent += "Attack=" + juce::String(gateAttackSlider.getValue(), 2) + "\n";
@@ -569,7 +812,7 @@ void MainComponent::savePreset(const juce::String& presetName)
     presetContent += "\n";
     
     presetContent += "[Compressor]\n";
-    presetContent += "Enabled=true\n";
+    presetContent += "Enabled=" + juce::String(engineSettings.compressorEnabled ? "true" : "false") + "\n";
     presetContent += "Threshold=" + juce::String(thresholdSlider.getValue(), 2) + "\n";
     presetContent += "Ratio=" + juce::String(ratioSlider.getValue(), 2) + "\n";
     presetContent += "Attack=" + juce::String(attackSlider.getValue(), 2) + "\n";
@@ -578,10 +821,10 @@ void MainComponent::savePreset(const juce::String& presetName)
     presetContent += "\n";
     
     presetContent += "[Limiter]\n";
-    presetContent += "Enabled=true\n";
+    presetContent += "Enabled=" + juce::String(engineSettings.limiterEnabled ? "true" : "false") + "\n";
     presetContent += "Ceiling=" + juce::String(ceilingSlider.getValue(), 2) + "\n";
     presetContent += "Lookahead=" + juce::String(lookaheadSlider.getValue(), 2) + "\n";
-    presetContent += "Release=" + juce::String(releaseSlider.getValue(), 2) + "\n";
+    presetContent += "Release=" + juce::String(engineSettings.limiterRelease, 2) + "\n";
     presetContent += "\n";
     
     presetContent += "[Output]\n";
@@ -661,26 +904,138 @@ void MainComponent::toggleProcessing()
 {
     if (!processingOn)
     {
-        deviceManager.addAudioCallback(&engine);
-        processingOn = true;
+        startProcessing();
         enableButton.setButtonText("Disable Processing");
-        juce::Logger::writeToLog("Engine ON");
+        juce::Logger::writeToLog(virtualDevice.isNativeMode() ? "Engine ON (native JACK)" : "Engine ON");
     }
     else
     {
-        deviceManager.removeAudioCallback(&engine);
-        processingOn = false;
+        stopProcessing();
         enableButton.setButtonText("Enable Processing");
         juce::Logger::writeToLog("Engine OFF");
     }
+
+    nativeJackButton.setEnabled(!processingOn && virtualDevice.isAvailable());
+}
+
+void MainComponent::startProcessing()
+{
+    if (nativeJackButton.getToggleState() && virtualDevice.isAvailable())
+    {
+        // JACK drives the engine from its own input port: no hardware
+        // callback and no FIFO hop, so the only latency is the JACK period
+        engine.setVirtualDevice(nullptr);
+        engine.prepareToPlay(virtualDevice.getSampleRate(), virtualDevice.getBufferSize());
+        virtualDevice.setActive(true);
+        virtualDevice.setNativeCallback(&engine);
+    }
+    else
+    {
+        engine.setVirtualDevice(&virtualDevice);
+        virtualDevice.setActive(true);
+        deviceManager.addAudioCallback(&engine);
+    }
+
+    processingOn = true;
+}
+
+void MainComponent::stopProcessing()
+{
+    if (virtualDevice.isNativeMode())
+        virtualDevice.setNativeCallback(nullptr);
+    else
+        deviceManager.removeAudioCallback(&engine);
+
+    virtualDevice.setActive(false);
+    processingOn = false;
+
+    if (auto* dummyDevice = dynamic_cast<DummyAudioIODevice*>(deviceManager.getCurrentAudioDevice()))
+        juce::Logger::writeToLog("Dummy device: " + dummyDevice->getStatistics().toString());
+
+    // Leave a trace of the last callbacks for chrome://tracing or Perfetto
+    if (StageTimer::isCompiledIn())
+    {
+        const auto traceFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                   .getChildFile("AudioProcessor-stages.json");
+        const auto result = StageTimer::writeChromeTrace(traceFile, 200);
+
+        juce::Logger::writeToLog(result.wasOk() ? "Stage trace written to " + traceFile.getFullPathName()
+                                                : "Stage trace failed: " + result.getErrorMessage());
+    }
+}
+
+void MainComponent::visibilityChanged()
+{
+    updateRefreshRate();
+}
+
+void MainComponent::updateRefreshRate()
+{
+    // isShowing() is false while the window or any parent is hidden or minimised
+    const bool showing = isShowing();
+
+    if (showing == meterDisplayActive)
+        return;
+
+    meterDisplayActive = showing;
+    startTimerHz(showing ? visibleRefreshHz : hiddenRefreshHz);
+
+    // Catch up straight away instead of on the next tick
+    if (showing)
+        timerCallback();
 }
 
 void MainComponent::timerCallback()
 {
-    // Pull latest levels from the audio thread; bind these to your meter widgets.
-    lastIn  = engine.inPeak.load();
-    lastOut = engine.outPeak.load();
-    lastGR  = engine.grDb.load();
+    // Every block since the last tick, so a short over between ticks still
+    // shows. Hidden ticks keep draining so the ring never has to merge.
+    engine.getMeterTap().drain([this](const MeterFrame& frame)
+    {
+        if (hasPendingMeterFrame)
+            pendingMeterFrame.merge(frame);
+        else
+            pendingMeterFrame = frame;
+
+        hasPendingMeterFrame = true;
+
+        meterHistory.addFrame(frame);
+        meterHistoryChanged = true;
+    });
+
+    // Once a second at either refresh rate, so load logging carries on while hidden
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+
+    if (now - lastDspLoadUpdateMs >= 1000.0)
+    {
+        lastDspLoadUpdateMs = now;
+        updateDspLoad();
+    }
+
+    // Minimise and restore are also reported by the window; this catches the
+    // rest. Coming back, updateRefreshRate() draws the catch-up frame itself.
+    if (isShowing() != meterDisplayActive)
+    {
+        updateRefreshRate();
+        return;
+    }
+
+    if (!meterDisplayActive)
+        return;
+
+    lastIn  = hasPendingMeterFrame ? pendingMeterFrame.inputPeak : 0.0f;
+    lastOut = hasPendingMeterFrame ? pendingMeterFrame.outputPeak : 0.0f;
+    lastGR  = hasPendingMeterFrame ? pendingMeterFrame.gainReductionDb : 0.0f;
+
+    if (hasPendingMeterFrame)
+        lastAutoGainDb = pendingMeterFrame.autoGainDb;
+
+    hasPendingMeterFrame = false;
+
+    if (meterHistoryChanged)
+    {
+        historyView.repaint();
+        meterHistoryChanged = false;
+    }
 
     // Update meters with clamped values
     float clampedIn  = juce::jlimit(0.0f, 1.0f, lastIn);
@@ -690,152 +1045,88 @@ void MainComponent::timerCallback()
     outputMeter->setValue(clampedOut);
     gainReductionMeter->setValue(lastGR / 20.0f); // Normalize to 0-1 range
 
-    repaint();
-}
+    // Loudness is shown as text; below the -70 LUFS gate there is nothing to show
+    auto formatLufs = [](float lufs) {
+        return lufs > -70.0f ? juce::String(lufs, 1) : juce::String("--");
+    };
 
-bool MainComponent::loadPresetFromFile(const juce::String& presetName)
-{
-    auto presetFile = getPresetFile(presetName);
-    return loadPresetFromFile(presetName, presetFile);
-}
+    loudnessLabel.setText("LUFS\n"
+                          "M  " + formatLufs(engine.momentaryLufs.load()) + "\n"
+                          "S  " + formatLufs(engine.shortTermLufs.load()) + "\n"
+                          "I  " + formatLufs(engine.integratedLufs.load()) + "\n"
+                          "LRA " + juce::String(engine.loudnessRange.load(), 1) + "\n"
+                          "AGC " + juce::String(lastAutoGainDb, 1) + " dB",
+                          juce::dontSendNotification);
 
-bool MainComponent::loadPresetFromFile(const juce::String& presetName, const juce::File& presetFile)
-{
-    if (!presetFile.exists())
+    if (virtualDevice.isAvailable())
     {
-        juce::Logger::writeToLog("Preset file not found: " + presetFile.getFullPathName());
-        return false;
+        // Native mode: lookahead plus the JACK period; otherwise also the FIFO
+        const bool native = virtualDevice.isNativeMode();
+        const int latencySamples = native ? engine.getLatencySamples() + virtualDevice.getLatencySamples()
+                                          : engine.getVirtualDeviceLatencySamples();
+        auto* device = deviceManager.getCurrentAudioDevice();
+        const double sampleRate = native ? virtualDevice.getSampleRate()
+                                         : (device != nullptr ? device->getCurrentSampleRate() : 0.0);
+
+        latencyLabel.setText("JACK out\n"
+                             + juce::String(latencySamples) + " smp\n"
+                             + (sampleRate > 0.0 ? juce::String(1000.0 * latencySamples / sampleRate, 1) + " ms" : juce::String("--")),
+                             juce::dontSendNotification);
     }
-    
-    if (!presetFile.existsAsFile())
+    else
     {
-        juce::Logger::writeToLog("Preset path is not a file: " + presetFile.getFullPathName());
-        return false;
+        latencyLabel.setText("JACK out\n--", juce::dontSendNotification);
     }
-    
-    auto fileContent = presetFile.loadFileAsString();
-    if (fileContent.isEmpty())
+
+    // No repaint() here: the meters, history and labels invalidate just what changed
+}
+
+void MainComponent::updateDspLoad()
+{
+    const auto report = engine.getProfiler().getReport();
+
+    auto* jackProfiler = virtualDevice.getProfiler();
+    const auto jackReport = jackProfiler != nullptr ? jackProfiler->getReport() : CallbackProfiler::Report();
+
+    if (!profileButton.getToggleState() || report.numCallbacks == 0)
     {
-        juce::Logger::writeToLog("Preset file is empty or could not be read: " + presetFile.getFullPathName());
-        return false;
+        dspLoadLabel.setText("DSP\n--", juce::dontSendNotification);
+        profileLogSeconds = 0;
+        return;
     }
-    auto lines = juce::StringArray::fromLines(fileContent);
-    
-    juce::String currentSection;
-    
-    for (auto line : lines)
+
+    dspLoadLabel.setText("DSP " + juce::String(report.loadPercent, 1) + "%\n"
+                         "p50 " + juce::String(juce::roundToInt(report.p50Micros)) + " us\n"
+                         "p99 " + juce::String(juce::roundToInt(report.p99Micros)) + " us\n"
+                         "max " + juce::String(juce::roundToInt(report.maxMicros)) + " us\n"
+                         "xrun " + juce::String(static_cast<juce::int64>(report.totalOverruns)),
+                         juce::dontSendNotification);
+
+    // Log every 10 s while processing, and straight away on a missed deadline
+    if (report.overruns > 0 || jackReport.overruns > 0 || ++profileLogSeconds >= 10)
     {
-        line = line.trim();
-        
-        // Skip empty lines and comments
-        if (line.isEmpty() || line.startsWith("#") || line.startsWith(";"))
-            continue;
-            
-        // Check for section headers
-        if (line.startsWith("[") && line.endsWith("]"))
-        {
-            currentSection = line.substring(1, line.length() - 1);
-            continue;
-        }
-        
-        // Parse key=value pairs
-        auto equalsIndex = line.indexOfChar('=');
-        if (equalsIndex == -1)
-            continue;
-            
-        auto key = line.substring(0, equalsIndex).trim();
-        auto value = line.substring(equalsIndex + 1).trim();
-        
-        // Apply values based on section and key with validation and clamping
-        if (currentSection == "Input")
-        {
-            if (key == "Gain")
-            {
-                double val = juce::jlimit(inputGainSlider.getMinimum(), inputGainSlider.getMaximum(), value.getDoubleValue());
-                inputGainSlider.setValue(val);
-            }
-        }
-        else if (currentSection == "NoiseGate")
-        {
-            if (key == "Threshold")
-            {
-                double val = juce::jlimit(gateThresholdSlider.getMinimum(), gateThresholdSlider.getMaximum(), value.getDoubleValue());
-                gateThresholdSlider.setValue(val);
-            }
-            else if (key == "Ratio")
-            {
-                double val = juce::jlimit(gateRatioSlider.getMinimum(), gateRatioSlider.getMaximum(), value.getDoubleValue());
-                gateRatioSlider.setValue(val);
-            }
-            else if (key == "Attack")
-            {
-                double val = juce::jlimit(gateAttackSlider.getMinimum(), gateAttackSlider.getMaximum(), value.getDoubleValue());
-                gateAttackSlider.setValue(val);
-            }
-            else if (key == "Release")
-            {
-                double val = juce::jlimit(gateReleaseSlider.getMinimum(), gateReleaseSlider.getMaximum(), value.getDoubleValue());
-                gateReleaseSlider.setValue(val);
-            }
-        }
-        else if (currentSection == "Compressor")
-        {
-            if (key == "Threshold")
-            {
-                double val = juce::jlimit(thresholdSlider.getMinimum(), thresholdSlider.getMaximum(), value.getDoubleValue());
-                thresholdSlider.setValue(val);
-            }
-            else if (key == "Ratio")
-            {
-                double val = juce::jlimit(ratioSlider.getMinimum(), ratioSlider.getMaximum(), value.getDoubleValue());
-                ratioSlider.setValue(val);
-            }
-            else if (key == "Attack")
-            {
-                double val = juce::jlimit(attackSlider.getMinimum(), attackSlider.getMaximum(), value.getDoubleValue());
-                attackSlider.setValue(val);
-            }
-            else if (key == "Release")
-            {
-                double val = juce::jlimit(releaseSlider.getMinimum(), releaseSlider.getMaximum(), value.getDoubleValue());
-                releaseSlider.setValue(val);
-            }
-            else if (key == "Knee")
-            {
-                double val = juce::jlimit(kneeSlider.getMinimum(), kneeSlider.getMaximum(), value.getDoubleValue());
-                kneeSlider.setValue(val);
-            }
-        }
-        else if (currentSection == "Limiter")
-        {
-            if (key == "Ceiling")
-            {
-                double val = juce::jlimit(ceilingSlider.getMinimum(), ceilingSlider.getMaximum(), value.getDoubleValue());
-                ceilingSlider.setValue(val);
-            }
-            else if (key == "Lookahead")
-            {
-                double val = juce::jlimit(lookaheadSlider.getMinimum(), lookaheadSlider.getMaximum(), value.getDoubleValue());
-                lookaheadSlider.setValue(val);
-            }
-            else if (key == "Release")
-                ; // Limiter release is handled by releaseSlider which is already set in Compressor section
-        }
-        else if (currentSection == "Output")
+        profileLogSeconds = 0;
+
+        juce::Logger::writeToLog("Audio callback: " + report.toString()
+                                 + (jackReport.numCallbacks > 0 ? " | JACK callback: " + jackReport.toString()
+                                                                : juce::String()));
+
+        // Where the time went, in builds configured with AUDIOPROCESSOR_STAGE_TIMING
+        if (StageTimer::isCompiledIn())
         {
-            if (key == "Gain")
-            {
-                double val = juce::jlimit(outputGainSlider.getMinimum(), outputGainSlider.getMaximum(), value.getDoubleValue());
-                outputGainSlider.setValue(val);
-            }
-            else if (key == "MakeupGain")
-            {
-                double val = juce::jlimit(makeupGainSlider.getMinimum(), makeupGainSlider.getMaximum(), value.getDoubleValue());
-                makeupGainSlider.setValue(val);
-            }
+            const auto stages = StageTimer::getSnapshot();
+            juce::Logger::writeToLog("Stages: " + StageTimer::toString(StageTimer::getDifference(stages, lastStageSnapshot)));
+            lastStageSnapshot = stages;
         }
     }
-    
+}
+
+bool MainComponent::loadPresetFromFile(const juce::File& presetFile, PresetSettings& preset)
+{
+    // Ranges are clamped by the parser to match the sliders
+    if (!preset.loadFromFile(presetFile))
+        return false;
+
     juce::Logger::writeToLog("Loaded preset from file: " + presetFile.getFullPathName());
     return true;
 }
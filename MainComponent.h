@@ -2,10 +2,13 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include "AudioEngine.h"
-#include "Compressor.h"
-#include "Limiter.h"
+#include "MeterHistory.h"
+#include "StageTimer.h"
 
-// Custom audio meter with green/yellow/red colors
+// Custom audio meter with green/yellow/red colors.
+// Drawn from two prerendered images (unlit and fully lit), split at the bar
+// top. setValue() only invalidates the rows that changed and does nothing
+// while the bar and peak line stay on the same pixel.
 class AudioMeter : public juce::Component
 {
 public:
@@ -22,9 +25,41 @@ private:
     float peakHoldTime = 1.0f; // seconds
     float peakDecayPerSecond = 0.5f; // units per second
 
+    // What is on screen, in whole pixels
+    int levelTop = 0;       // y of the top of the bar
+    int peakY = -1;         // -1 = no peak line
+
+    // Rendered at the display's pixel scale on first paint after a resize
+    juce::Image unlitImage, litImage;
+    float imageScale = 0.0f;
+
+    juce::Rectangle<int> getBarArea() const { return getLocalBounds().reduced(2); }
+    int getLevelY(float value) const;
+    juce::Rectangle<int> getPeakLineArea(int y) const { return { 0, y - 1, getWidth(), 2 }; }
+    void renderImages(float scale);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioMeter)
 };
 
+// Scrolling output level, gain reduction and gate history, one MeterHistory
+// column per pixel, so a repaint costs the same at any zoom. The mouse wheel
+// zooms between 1 s and the whole history.
+class HistoryView : public juce::Component
+{
+public:
+    explicit HistoryView(const MeterHistory& historyToShow);
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) override;
+
+private:
+    const MeterHistory& history;
+    double visibleSeconds;
+    std::vector<MeterHistory::Bin> columns;     // one per pixel, sized in resized()
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HistoryView)
+};
+
 class MainComponent : public juce::Component,
                       private juce::Timer
 {
@@ -34,11 +69,17 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    void visibilityChanged() override;
+
+    // Full meter refresh while on screen, a slow background tick while hidden
+    // or minimised; called by the window when it is minimised or restored
+    void updateRefreshRate();
 
 private:
     // Device controls
     juce::ComboBox inputDeviceBox, outputDeviceBox;
     juce::TextButton enableButton { "Enable Processing" };
+    juce::ToggleButton nativeJackButton { "Native JACK" };   // run the chain in the JACK callback
 
     // Audio processing controls - all vertical sliders
     juce::Slider inputGainSlider, outputGainSlider;
@@ -73,31 +114,63 @@ private:
     std::unique_ptr<AudioMeter> outputMeter;
     std::unique_ptr<AudioMeter> gainReductionMeter;
 
-    // Values you can pipe into your on-screen meter components
+    // Last 30 s of the meter stream, fed on every tick (also while hidden)
+    MeterHistory meterHistory;
+    HistoryView historyView { meterHistory };
+    bool meterHistoryChanged = false;
+
+    // Output loudness readout (momentary / short-term / integrated LUFS, LRA)
+    juce::Label loudnessLabel;
+
+    // Added latency to the JACK virtual device outputs
+    juce::Label latencyLabel;
+
+    // Audio callback load against its deadline, refreshed once a second
+    juce::Label dspLoadLabel;
+    juce::ToggleButton profileButton { "Profile" };
+    double lastDspLoadUpdateMs = 0.0;
+    int profileLogSeconds = 0;
+    StageTimer::Snapshot lastStageSnapshot {};
+
+    // Worst case of the meter frames drained on the last tick (zero when none arrived)
     float lastIn = 0.f, lastOut = 0.f, lastGR = 0.f;
+    float lastAutoGainDb = 0.f;
+
+    // While hidden the timer only drains the meter stream into one pending
+    // frame, which is drawn as soon as the window is back
+    static constexpr int visibleRefreshHz = 30;
+    static constexpr int hiddenRefreshHz = 2;
+    bool meterDisplayActive = true;
+    MeterFrame pendingMeterFrame;
+    bool hasPendingMeterFrame = false;
 
     juce::AudioDeviceManager deviceManager;
+    VirtualAudioDevice virtualDevice;   // declared before the engine that writes to it
     AudioEngine engine;
-    Compressor compressor;
-    Limiter limiter;
+
+    // Full parameter set as last published to the engine; slider values are
+    // copied in by updateEngineParameters(), switches are set by presets
+    PresetSettings engineSettings;
     bool processingOn = false;
 
     void refreshDeviceLists();
     void setInputDevice(const juce::String& name);
     void setOutputDevice(const juce::String& name);
     void toggleProcessing();
+    void startProcessing();
+    void stopProcessing();
 
     void setupSliders();
     void setupLabels();
     void setupPresets();
     void updateEngineParameters();
     void loadPreset(const juce::String& presetName);
+    void applyPreset(const PresetSettings& preset);
     void savePreset(const juce::String& presetName);
     void refreshPresetList();
     
     // Helper methods for file-based preset management
-    bool loadPresetFromFile(const juce::String& presetName);
-    bool loadPresetFromFile(const juce::String& presetName, const juce::File& presetFile);
+    bool loadPresetFromFile(const juce::File& presetFile, PresetSettings& preset);
     juce::File getPresetFile(const juce::String& presetName);
     juce::File getPresetDirectory();
     bool isBuiltInPreset(const juce::String& presetName);
@@ -127,6 +200,7 @@ private:
     CustomLookAndFeel customLookAndFeel;
 
     void timerCallback() override;
+    void updateDspLoad();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
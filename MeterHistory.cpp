@@ -0,0 +1,161 @@
+#include "MeterHistory.h"
+
+//==============================================================================
+void MeterHistory::Bin::add(const MeterFrame& frame) noexcept
+{
+    outputPeak.add(frame.outputPeak);
+    gainReductionDb.add(frame.gainReductionDb);
+    gateReductionDb.add(frame.gateReductionDb);
+}
+
+void MeterHistory::Bin::add(const Bin& other) noexcept
+{
+    outputPeak.add(other.outputPeak);
+    gainReductionDb.add(other.gainReductionDb);
+    gateReductionDb.add(other.gateReductionDb);
+}
+
+//==============================================================================
+MeterHistory::MeterHistory(double historySecondsToKeep, double binSecondsToUse)
+    : historySeconds(juce::jmax(1.0, historySecondsToKeep)),
+      binSeconds(juce::jlimit(0.0001, historySeconds, binSecondsToUse))
+{
+    // Level n holds bins of 2^n level-0 bins; stop once a level needs only a couple
+    const auto historyBins = static_cast<juce::int64>(std::ceil(historySeconds / binSeconds));
+
+    for (juce::int64 binsAtLevel = historyBins; ; binsAtLevel = (binsAtLevel + 1) / 2)
+    {
+        Level level;
+        level.bins.resize(static_cast<size_t>(binsAtLevel + 2));
+        levels.push_back(std::move(level));
+
+        if (binsAtLevel <= 2)
+            break;
+    }
+}
+
+void MeterHistory::clear()
+{
+    for (auto& level : levels)
+        level.count = 0;
+
+    currentBin = {};
+    currentBinSeconds = 0.0;
+}
+
+void MeterHistory::addFrame(const MeterFrame& frame)
+{
+    if (frame.sampleRate <= 0.0f || frame.numSamples <= 0)
+        return;
+
+    // Anything longer than the history (a merged backlog) only needs its tail
+    auto secondsLeft = juce::jmin(static_cast<double>(frame.numSamples) / frame.sampleRate,
+                                  historySeconds + binSeconds);
+
+    while (secondsLeft > 0.0)
+    {
+        const auto secondsInBin = juce::jmin(secondsLeft, binSeconds - currentBinSeconds);
+
+        currentBin.add(frame);
+        currentBinSeconds += secondsInBin;
+        secondsLeft -= secondsInBin;
+
+        // Tolerance, so that rounding never leaves a sliver of a bin behind
+        if (currentBinSeconds >= binSeconds * 0.999)
+        {
+            pushBin(currentBin);
+            currentBin = {};
+            currentBinSeconds = 0.0;
+        }
+    }
+}
+
+void MeterHistory::pushBin(const Bin& bin)
+{
+    auto carry = bin;
+
+    for (auto& level : levels)
+    {
+        const auto size = static_cast<juce::int64>(level.bins.size());
+        level.bins[static_cast<size_t>(level.count % size)] = carry;
+        ++level.count;
+
+        // Every second bin completes a pair for the level above
+        if (level.count % 2 != 0)
+            break;
+
+        carry = level.bins[static_cast<size_t>((level.count - 2) % size)];
+        carry.add(level.bins[static_cast<size_t>((level.count - 1) % size)]);
+    }
+}
+
+bool MeterHistory::isAvailable(int level, juce::int64 binNumber) const noexcept
+{
+    const auto& bins = levels[static_cast<size_t>(level)];
+    return binNumber < bins.count && binNumber >= bins.count - static_cast<juce::int64>(bins.bins.size());
+}
+
+//==============================================================================
+MeterHistory::Bin MeterHistory::getRange(juce::int64 firstBin, juce::int64 endBin) const
+{
+    Bin result;
+    const auto& finest = levels.front();
+
+    // The level-0 bin still being filled counts as the newest one
+    if (endBin > finest.count)
+    {
+        if (currentBinSeconds > 0.0 && firstBin <= finest.count)
+            result.add(currentBin);
+
+        endBin = finest.count;
+    }
+
+    firstBin = juce::jmax(firstBin, finest.count - static_cast<juce::int64>(finest.bins.size()), juce::int64 { 0 });
+
+    // Largest aligned bins that fit, like walking down a segment tree
+    while (firstBin < endBin)
+    {
+        int level = 0;
+
+        while (level + 1 < static_cast<int>(levels.size()))
+        {
+            const auto span = juce::int64 { 2 } << level;
+
+            if (firstBin % span != 0 || firstBin + span > endBin || !isAvailable(level + 1, firstBin / span))
+                break;
+
+            ++level;
+        }
+
+        const auto& bins = levels[static_cast<size_t>(level)];
+        const auto binNumber = firstBin >> level;
+        result.add(bins.bins[static_cast<size_t>(binNumber % static_cast<juce::int64>(bins.bins.size()))]);
+
+        firstBin += juce::int64 { 1 } << level;
+    }
+
+    return result;
+}
+
+void MeterHistory::getColumns(Bin* columns, int numColumns, double seconds) const
+{
+    if (numColumns <= 0)
+        return;
+
+    seconds = juce::jlimit(binSeconds, historySeconds, seconds);
+
+    // Columns are numbered from the start of the history, so their edges stay
+    // put as time moves on and the newest one fills up from the right
+    const auto binsPerColumn = seconds / binSeconds / numColumns;
+    const auto nowInBins = static_cast<double>(levels.front().count) + currentBinSeconds / binSeconds;
+    const auto newestColumn = static_cast<juce::int64>(std::ceil(nowInBins / binsPerColumn)) - 1;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto columnNumber = newestColumn - (numColumns - 1) + column;
+        const auto firstBin = static_cast<juce::int64>(std::floor(static_cast<double>(columnNumber) * binsPerColumn));
+        const auto endBin = juce::jmax(firstBin + 1, static_cast<juce::int64>(std::floor(static_cast<double>(columnNumber + 1) * binsPerColumn)));
+
+        columns[column] = columnNumber >= 0 ? getRange(firstBin, endBin) : Bin();
+    }
+}
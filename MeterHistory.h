@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <limits>
+#include <vector>
+#include "MeterTap.h"
+
+//==============================================================================
+// Scrolling history of the meter stream as a min/max pyramid (UI thread).
+//
+// Frames are binned by time into fixed level-0 bins; every completed pair of
+// bins is merged into one bin of the next level, and so on up. Each level is
+// a ring sized for the history length, so memory is fixed at construction
+// (about twice the level-0 ring) and adding a frame is O(levels).
+//
+// getColumns() reduces any span of the history to one bin per pixel column by
+// combining the largest aligned bins that fit, which costs O(columns * levels)
+// whatever the zoom.
+class MeterHistory
+{
+public:
+    struct MinMax
+    {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+
+        bool isEmpty() const noexcept { return min > max; }
+        void add(float value) noexcept { min = juce::jmin(min, value); max = juce::jmax(max, value); }
+        void add(const MinMax& other) noexcept { min = juce::jmin(min, other.min); max = juce::jmax(max, other.max); }
+    };
+
+    // Ranges of the per-block values that fell into a bin
+    struct Bin
+    {
+        MinMax outputPeak;          // linear
+        MinMax gainReductionDb;
+        MinMax gateReductionDb;
+
+        bool isEmpty() const noexcept { return outputPeak.isEmpty(); }
+        void add(const MeterFrame& frame) noexcept;
+        void add(const Bin& other) noexcept;
+    };
+
+    explicit MeterHistory(double historySeconds = 30.0, double binSeconds = 0.005);
+
+    void clear();
+
+    // Appends a frame after the previous one; frames without a sample rate are ignored
+    void addFrame(const MeterFrame& frame);
+
+    // Writes numColumns bins covering the last `seconds` of history, oldest
+    // first; columns with no audio come back empty. Column boundaries are
+    // fixed in time, so the picture scrolls instead of shimmering.
+    void getColumns(Bin* columns, int numColumns, double seconds) const;
+
+    double getHistorySeconds() const noexcept { return historySeconds; }
+
+private:
+    struct Level
+    {
+        std::vector<Bin> bins;      // ring, indexed by bin number % size
+        juce::int64 count = 0;      // bins completed at this level
+    };
+
+    const double historySeconds;
+    const double binSeconds;
+
+    std::vector<Level> levels;
+    Bin currentBin;                 // level-0 bin being filled
+    double currentBinSeconds = 0.0; // how much of it is filled
+
+    void pushBin(const Bin& bin);
+    bool isAvailable(int level, juce::int64 binNumber) const noexcept;
+    Bin getRange(juce::int64 firstBin, juce::int64 endBin) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterHistory)
+};
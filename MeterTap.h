@@ -0,0 +1,148 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include "SpscFifo.h"
+
+//==============================================================================
+// Meter readings for one audio callback.
+struct MeterFrame
+{
+    juce::int64 samplePosition = 0;     // of the first sample, counted from the engine's last prepareToPlay
+    int numSamples = 0;
+    float sampleRate = 0.0f;
+
+    float inputPeak = 0.0f;             // linear, after the input gain
+    float outputPeak = 0.0f;            // linear
+    float inputSumOfSquares = 0.0f;     // RMS = sqrt(sum / numSamples), see getInputRms()
+    float outputSumOfSquares = 0.0f;
+
+    float gainReductionDb = 0.0f;       // compressor + limiter, positive
+    float gateReductionDb = 0.0f;       // positive; 0 while the gate is open
+    float autoGainDb = 0.0f;            // gain applied by the AGC at the end of the block
+
+    float getInputRms() const noexcept  { return numSamples > 0 ? std::sqrt(inputSumOfSquares / static_cast<float>(numSamples)) : 0.0f; }
+    float getOutputRms() const noexcept { return numSamples > 0 ? std::sqrt(outputSumOfSquares / static_cast<float>(numSamples)) : 0.0f; }
+
+    // Folds the frame that followed this one into it: peaks and reductions
+    // keep their maximum, energy adds up, the auto gain is the later one
+    void merge(const MeterFrame& later) noexcept
+    {
+        numSamples += later.numSamples;
+        sampleRate = later.sampleRate;
+        inputPeak = juce::jmax(inputPeak, later.inputPeak);
+        outputPeak = juce::jmax(outputPeak, later.outputPeak);
+        inputSumOfSquares += later.inputSumOfSquares;
+        outputSumOfSquares += later.outputSumOfSquares;
+        gainReductionDb = juce::jmax(gainReductionDb, later.gainReductionDb);
+        gateReductionDb = juce::jmax(gateReductionDb, later.gateReductionDb);
+        autoGainDb = later.autoGainDb;
+    }
+};
+
+//==============================================================================
+// Lossless meter stream from the audio thread to the UI.
+//
+// The audio thread pushes one MeterFrame per callback into a fixed ring of
+// frames indexed by an SpscFifo, so push() never allocates, locks or waits.
+// The UI drains every frame since its last tick, either one by one (history
+// graphs) or merged into one (level meters), so a single-block over between
+// two ticks is never missed.
+//
+// If the UI falls so far behind that the ring is full, the audio thread
+// merges new frames into one pending frame and pushes that as soon as there
+// is room: peaks and gain reduction still arrive, only their timing is
+// coarser. getNumMergedFrames() counts how often that happened.
+class MeterTap
+{
+public:
+    static constexpr int defaultCapacity = 4096;    // > 1 s of 16-sample blocks at 48 kHz
+
+    explicit MeterTap(int minimumCapacity = defaultCapacity)
+        : fifo(minimumCapacity)
+    {
+        frames.allocate(static_cast<size_t>(fifo.getCapacity()), true);
+    }
+
+    //==============================================================================
+    // Audio thread
+    void push(const MeterFrame& frame) noexcept
+    {
+        if (hasPendingFrame)
+        {
+            pendingFrame.merge(frame);
+            hasPendingFrame = !write(pendingFrame);
+            return;
+        }
+
+        if (!write(frame))
+        {
+            pendingFrame = frame;
+            hasPendingFrame = true;
+        }
+    }
+
+    //==============================================================================
+    // UI thread: calls frameHandler(const MeterFrame&) for every frame since
+    // the last drain, oldest first, and returns how many there were
+    template <typename FrameHandler>
+    int drain(FrameHandler&& frameHandler)
+    {
+        const auto region = fifo.prepareToRead(fifo.getNumReady());
+
+        for (int i = 0; i < region.size1; ++i)
+            frameHandler(frames[region.start1 + i]);
+
+        for (int i = 0; i < region.size2; ++i)
+            frameHandler(frames[region.start2 + i]);
+
+        fifo.finishedRead(region.getTotalSize());
+        return region.getTotalSize();
+    }
+
+    // Merges every frame since the last drain into summary; false if none arrived
+    bool drain(MeterFrame& summary)
+    {
+        bool isFirst = true;
+
+        drain([&summary, &isFirst](const MeterFrame& frame)
+        {
+            if (isFirst)
+                summary = frame;
+            else
+                summary.merge(frame);
+
+            isFirst = false;
+        });
+
+        return !isFirst;
+    }
+
+    // Frames that had to be merged because the ring was full (any thread)
+    uint32_t getNumMergedFrames() const noexcept { return fifo.getOverrunCount(); }
+
+private:
+    SpscFifo fifo;
+    juce::HeapBlock<MeterFrame> frames;
+
+    // Audio thread only
+    MeterFrame pendingFrame;
+    bool hasPendingFrame = false;
+
+    bool write(const MeterFrame& frame) noexcept
+    {
+        const auto region = fifo.prepareToWrite(1);
+
+        if (region.getTotalSize() == 0)
+        {
+            fifo.reportOverrun();
+            return false;
+        }
+
+        frames[region.start1] = frame;
+        fifo.finishedWrite(1);
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(MeterTap)
+};
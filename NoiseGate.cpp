@@ -0,0 +1,117 @@
+#include "NoiseGate.h"
+
+//==============================================================================
+NoiseGate::NoiseGate()
+{
+    parameters.prepare(sampleRate);
+}
+
+NoiseGate::~NoiseGate()
+{
+    releaseResources();
+}
+
+void NoiseGate::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    this->sampleRate = sampleRate;
+    this->blockSize = samplesPerBlock;
+
+    // Envelope and gain scratch for one block; keeps its storage when
+    // prepared again for the same size or less
+    scratchBuffer.setSize(2, juce::jmax(1, samplesPerBlock), false, false, true);
+    scratchBuffer.clear();
+
+    envelope = 0.0f;
+    currentGainReduction = 0.0f;
+
+    parameters.prepare(sampleRate);
+}
+
+float NoiseGate::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
+{
+    const int numSamples = static_cast<int>(audioBlock.getNumSamples());
+    const int maxChunk = scratchBuffer.getNumSamples();
+
+    float minGain = 1.0f;
+
+    // Larger-than-prepared blocks are handled in scratch-sized pieces
+    for (int offset = 0; offset < numSamples; offset += maxChunk)
+    {
+        const int chunk = juce::jmin(maxChunk, numSamples - offset);
+        auto subBlock = audioBlock.getSubBlock(static_cast<size_t>(offset), static_cast<size_t>(chunk));
+        processSubBlock(subBlock, minGain);
+    }
+
+    currentGainReduction = -juce::Decibels::gainToDecibels(minGain);
+    return currentGainReduction;
+}
+
+void NoiseGate::releaseResources()
+{
+    scratchBuffer.setSize(0, 0);
+}
+
+//==============================================================================
+void NoiseGate::Parameters::prepare(double sampleRate)
+{
+    ratio = juce::jmax(1.0f, ratio);
+    attack = juce::jmax(0.1f, attack);
+    release = juce::jmax(1.0f, release);
+
+    thresholdGain = juce::Decibels::decibelsToGain(threshold);
+    attackCoeff = std::exp(-1.0f / (attack * 0.001f * static_cast<float>(sampleRate)));
+    releaseCoeff = std::exp(-1.0f / (release * 0.001f * static_cast<float>(sampleRate)));
+}
+
+void NoiseGate::setThreshold(float thresholdDb)
+{
+    parameters.threshold = thresholdDb;
+    parameters.prepare(sampleRate);
+}
+
+void NoiseGate::setRatio(float ratio)
+{
+    parameters.ratio = ratio;
+    parameters.prepare(sampleRate);
+}
+
+void NoiseGate::setAttack(float attackMs)
+{
+    parameters.attack = attackMs;
+    parameters.prepare(sampleRate);
+}
+
+void NoiseGate::setRelease(float releaseMs)
+{
+    parameters.release = releaseMs;
+    parameters.prepare(sampleRate);
+}
+
+//==============================================================================
+void NoiseGate::processSubBlock(juce::dsp::AudioBlock<float>& audioBlock, float& minGain)
+{
+    const int numChannels = static_cast<int>(audioBlock.getNumChannels());
+    const int numSamples = static_cast<int>(audioBlock.getNumSamples());
+
+    auto* envelopeData = scratchBuffer.getWritePointer(0);
+    auto* gainData = scratchBuffer.getWritePointer(1);
+
+    // Detector pass: peak across channels, attack/release one-pole
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float level = 0.0f;
+        for (int channel = 0; channel < numChannels; ++channel)
+            level = juce::jmax(level, std::abs(audioBlock.getChannelPointer(channel)[sample]));
+
+        const float coeff = level > envelope ? parameters.attackCoeff : parameters.releaseCoeff;
+        envelope = level + (envelope - level) * coeff;
+        envelopeData[sample] = envelope;
+    }
+
+    // Gain pass over the whole block
+    gainComputer.computeExpanderGains(envelopeData, gainData, numSamples, parameters.thresholdGain, parameters.ratio);
+    minGain = juce::jmin(minGain, juce::FloatVectorOperations::findMinimum(gainData, numSamples));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::multiply(audioBlock.getChannelPointer(channel), gainData, numSamples);
+}
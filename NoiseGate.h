@@ -0,0 +1,68 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "GainComputer.h"
+
+//==============================================================================
+class NoiseGate
+{
+public:
+    NoiseGate();
+    ~NoiseGate();
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    float processBlock(juce::dsp::AudioBlock<float>& audioBlock);
+    void releaseResources();
+
+    // Complete parameter set. prepare() clamps the values and derives the
+    // coefficients for a sample rate, so setParameters() is a plain copy
+    // that is safe to call on the audio thread.
+    struct Parameters
+    {
+        float threshold = -60.0f;        // dB
+        float ratio = 10.0f;             // expansion ratio
+        float attack = 1.0f;             // ms
+        float release = 100.0f;          // ms
+
+        // Derived by prepare()
+        float thresholdGain = 0.001f;
+        float attackCoeff = 0.0f;
+        float releaseCoeff = 0.0f;
+
+        void prepare(double sampleRate);
+    };
+
+    void setParameters(const Parameters& newParameters) { parameters = newParameters; }
+    const Parameters& getParameters() const { return parameters; }
+
+    // Single-parameter setters (derive coefficients in place)
+    void setThreshold(float thresholdDb);
+    void setRatio(float ratio);
+    void setAttack(float attackMs);
+    void setRelease(float releaseMs);
+
+    // Getters
+    float getGainReduction() const { return currentGainReduction; }
+
+private:
+    Parameters parameters;
+
+    // Processing state
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+
+    // Envelope follower (peak, linked across channels)
+    float envelope = 0.0f;
+
+    // Gain reduction
+    float currentGainReduction = 0.0f;
+
+    // Block scratch: detector envelope and computed gains
+    juce::AudioBuffer<float> scratchBuffer;
+    GainComputer gainComputer;
+
+    // Helper functions
+    void processSubBlock(juce::dsp::AudioBlock<float>& audioBlock, float& minGain);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NoiseGate)
+};
@@ -0,0 +1,122 @@
+#include "OfflineRenderer.h"
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer(int blockSizeToUse)
+    : blockSize(juce::jmax(16, blockSizeToUse))
+{
+    formatManager.registerBasicFormats();
+}
+
+juce::Result OfflineRenderer::renderFile(const juce::File& inputFile, const juce::File& outputFile, Stats& stats)
+{
+    stats = {};
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+    if (reader == nullptr)
+        return juce::Result::fail("Unsupported or unreadable input file: " + inputFile.getFullPathName());
+
+    auto* format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+    if (format == nullptr)
+        return juce::Result::fail("No audio format for output extension: " + outputFile.getFileName());
+
+    const auto numChannels = static_cast<int>(reader->numChannels);
+    const auto sampleRate = reader->sampleRate;
+    const auto totalSamples = reader->lengthInSamples;
+
+    if (numChannels <= 0 || sampleRate <= 0.0)
+        return juce::Result::fail("Input file has no audio: " + inputFile.getFullPathName());
+
+    if (!outputFile.deleteFile())
+        return juce::Result::fail("Cannot overwrite output file: " + outputFile.getFullPathName());
+
+    std::unique_ptr<juce::FileOutputStream> outputStream(outputFile.createOutputStream());
+    if (outputStream == nullptr)
+        return juce::Result::fail("Cannot create output file: " + outputFile.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(outputStream.get(),
+                                                                            sampleRate,
+                                                                            static_cast<unsigned int>(numChannels),
+                                                                            chooseBitDepth(*format, static_cast<int>(reader->bitsPerSample)),
+                                                                            {},
+                                                                            0));
+    if (writer == nullptr)
+        return juce::Result::fail("The " + format->getFormatName() + " writer does not support this channel count or sample rate");
+
+    outputStream.release(); // now owned by the writer
+
+    // Keeps its allocation when a later file needs the same size or less
+    buffer.setSize(numChannels, blockSize, false, false, true);
+
+    chain.prepareToPlay(sampleRate, blockSize, numChannels);
+    chain.applySettings(settings);
+    loudnessMeter.prepareToPlay(sampleRate, numChannels);
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    // Drop the first latency samples and flush the lookahead with silence at the end
+    int samplesToSkip = chain.getLatencySamples();
+    juce::int64 readPosition = 0;
+    juce::int64 samplesWritten = 0;
+
+    while (samplesWritten < totalSamples)
+    {
+        // Always process whole blocks: the compressor detector runs at block rate
+        const int numToRead = static_cast<int>(juce::jlimit((juce::int64) 0, (juce::int64) blockSize, totalSamples - readPosition));
+
+        if (numToRead > 0)
+            reader->read(&buffer, 0, numToRead, readPosition, true, true);
+
+        if (numToRead < blockSize)
+            buffer.clear(numToRead, blockSize - numToRead);
+
+        readPosition += numToRead;
+
+        if (const auto inputGain = settings.getInputGain(); inputGain != 1.0f)
+            buffer.applyGain(inputGain);
+
+        juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(),
+                                           static_cast<size_t>(numChannels),
+                                           static_cast<size_t>(blockSize));
+        chain.processBlock(block);
+
+        const int skip = juce::jmin(samplesToSkip, blockSize);
+        samplesToSkip -= skip;
+
+        const int numToWrite = static_cast<int>(juce::jmin((juce::int64) (blockSize - skip), totalSamples - samplesWritten));
+
+        if (numToWrite > 0)
+        {
+            loudnessMeter.processBlock(block.getSubBlock(static_cast<size_t>(skip), static_cast<size_t>(numToWrite)));
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, skip, numToWrite))
+                return juce::Result::fail("Write failed: " + outputFile.getFullPathName());
+
+            samplesWritten += numToWrite;
+        }
+    }
+
+    writer.reset(); // flushes and finalises the header
+
+    // The chain stays prepared: the next file in a batch re-prepares it in
+    // place, and the chain frees it when the renderer goes
+
+    stats.integratedLufs = loudnessMeter.getIntegratedLoudness();
+    stats.loudnessRange = loudnessMeter.getLoudnessRange();
+    stats.audioSeconds = static_cast<double>(totalSamples) / sampleRate;
+    stats.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    return juce::Result::ok();
+}
+
+int OfflineRenderer::chooseBitDepth(juce::AudioFormat& format, int sourceBitDepth)
+{
+    const auto depths = format.getPossibleBitDepths();
+
+    if (depths.contains(sourceBitDepth))
+        return sourceBitDepth;
+
+    if (depths.contains(24))
+        return 24;
+
+    return depths.isEmpty() ? 16 : depths.getLast();
+}
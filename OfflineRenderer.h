@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessingChain.h"
+#include "PresetSettings.h"
+#include "LoudnessMeter.h"
+
+//==============================================================================
+// Runs the realtime ProcessingChain over audio files without a device.
+// Files are streamed through one fixed-size block buffer, so memory use does
+// not depend on file length. The limiter's lookahead delay is compensated:
+// the output starts at sample 0 and has exactly the input's length.
+class OfflineRenderer
+{
+public:
+    struct Stats
+    {
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+        float integratedLufs = LoudnessMeter::silenceLufs;   // of the output
+        float loudnessRange = 0.0f;
+
+        double getRealtimeFactor() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+    };
+
+    explicit OfflineRenderer(int blockSize = defaultBlockSize);
+
+    void setSettings(const PresetSettings& newSettings) { settings = newSettings; }
+    const PresetSettings& getSettings() const { return settings; }
+
+    // Output format is picked from the output file's extension (wav, flac, aiff...)
+    juce::Result renderFile(const juce::File& inputFile, const juce::File& outputFile, Stats& stats);
+
+    juce::AudioFormatManager& getFormatManager() { return formatManager; }
+
+    static constexpr int defaultBlockSize = 512;
+
+private:
+    const int blockSize;
+
+    juce::AudioFormatManager formatManager;
+    ProcessingChain chain;
+    LoudnessMeter loudnessMeter;
+    PresetSettings settings;
+    juce::AudioBuffer<float> buffer;
+
+    static int chooseBitDepth(juce::AudioFormat& format, int sourceBitDepth);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
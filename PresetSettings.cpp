@@ -0,0 +1,117 @@
+#include "PresetSettings.h"
+
+namespace
+{
+    bool parseEnabled(const juce::String& value)
+    {
+        return value.getIntValue() != 0 || value.equalsIgnoreCase("true");
+    }
+
+    float clampWithWarning(const juce::String& name, const juce::String& value, float minimum, float maximum)
+    {
+        const auto parsed = value.getFloatValue();
+        const auto clamped = juce::jlimit(minimum, maximum, parsed);
+
+        if (clamped != parsed)
+            juce::Logger::writeToLog("Warning: preset value " + name + "=" + value + " is outside "
+                                     + juce::String(minimum) + " to " + juce::String(maximum)
+                                     + ", using " + juce::String(clamped));
+
+        return clamped;
+    }
+}
+
+//==============================================================================
+void PresetSettings::parse(const juce::String& presetText)
+{
+    juce::String currentSection;
+
+    for (auto line : juce::StringArray::fromLines(presetText))
+    {
+        line = line.trim();
+
+        // Skip empty lines and comments
+        if (line.isEmpty() || line.startsWith("#") || line.startsWith(";"))
+            continue;
+
+        if (line.startsWith("[") && line.endsWith("]"))
+        {
+            currentSection = line.substring(1, line.length() - 1);
+            continue;
+        }
+
+        auto equalsIndex = line.indexOfChar('=');
+        if (equalsIndex == -1)
+            continue;
+
+        auto key = line.substring(0, equalsIndex).trim();
+        auto value = line.substring(equalsIndex + 1).trim();
+
+        auto parseClamped = [&currentSection, &key, &value](float minimum, float maximum)
+        {
+            return clampWithWarning("[" + currentSection + "] " + key, value, minimum, maximum);
+        };
+
+        // Ranges match the sliders in MainComponent::setupSliders()
+        if (currentSection == "Audio Processor Preset")
+        {
+            if (key == "Name")              name = value;
+            else if (key == "Description")  description = value;
+        }
+        else if (currentSection == "Input")
+        {
+            if (key == "Gain")              inputGainDb = parseClamped(-20.0f, 20.0f);
+            else if (key == "AutoGain")     autoGainEnabled = parseEnabled(value);
+            else if (key == "TargetLUFS")   autoGainTarget = parseClamped(-40.0f, -6.0f);
+            else if (key == "MaxBoost")     autoGainMaxBoost = parseClamped(0.0f, 30.0f);
+        }
+        else if (currentSection == "NoiseGate")
+        {
+            if (key == "Enabled")           gateEnabled = parseEnabled(value);
+            else if (key == "Threshold")    gateThreshold = parseClamped(-80.0f, 0.0f);
+            else if (key == "Ratio")        gateRatio = parseClamped(1.0f, 50.0f);
+            else if (key == "Attack")       gateAttack = parseClamped(0.1f, 100.0f);
+            else if (key == "Release")      gateRelease = parseClamped(10.0f, 1000.0f);
+        }
+        else if (currentSection == "Compressor")
+        {
+            if (key == "Enabled")           compressorEnabled = parseEnabled(value);
+            else if (key == "Threshold")    threshold = parseClamped(-60.0f, 0.0f);
+            else if (key == "Ratio")        ratio = parseClamped(1.0f, 20.0f);
+            else if (key == "Attack")       attack = parseClamped(0.1f, 100.0f);
+            else if (key == "Release")      release = parseClamped(10.0f, 1000.0f);
+            else if (key == "Knee")         knee = parseClamped(0.0f, 20.0f);
+        }
+        else if (currentSection == "Limiter")
+        {
+            if (key == "Enabled")           limiterEnabled = parseEnabled(value);
+            else if (key == "Ceiling")      ceiling = parseClamped(-20.0f, 0.0f);
+            else if (key == "Lookahead")    lookahead = parseClamped(0.0f, 10.0f);
+            else if (key == "Release")      limiterRelease = parseClamped(10.0f, 1000.0f);
+        }
+        else if (currentSection == "Output")
+        {
+            if (key == "Gain")              outputGainDb = parseClamped(-20.0f, 20.0f);
+            else if (key == "MakeupGain")   makeupGain = parseClamped(-20.0f, 20.0f);
+        }
+    }
+}
+
+bool PresetSettings::loadFromFile(const juce::File& presetFile)
+{
+    if (!presetFile.existsAsFile())
+    {
+        juce::Logger::writeToLog("Preset file not found: " + presetFile.getFullPathName());
+        return false;
+    }
+
+    auto fileContent = presetFile.loadFileAsString();
+    if (fileContent.isEmpty())
+    {
+        juce::Logger::writeToLog("Preset file is empty or could not be read: " + presetFile.getFullPathName());
+        return false;
+    }
+
+    parse(fileContent);
+    return true;
+}
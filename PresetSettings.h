@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Plain value copy of everything a .preset file describes, independent of the
+// UI. Values are clamped to the same ranges as the MainComponent sliders so a
+// preset renders identically in the app and in the headless tools.
+struct PresetSettings
+{
+    juce::String name;
+    juce::String description;
+
+    // [Input]
+    float inputGainDb = 0.0f;        // dB
+    bool autoGainEnabled = false;
+    float autoGainTarget = -16.0f;   // LUFS
+    float autoGainMaxBoost = 12.0f;  // dB
+
+    // [NoiseGate]
+    bool gateEnabled = true;
+    float gateThreshold = -60.0f;    // dB
+    float gateRatio = 10.0f;
+    float gateAttack = 1.0f;         // ms
+    float gateRelease = 100.0f;      // ms
+
+    // [Compressor]
+    bool compressorEnabled = true;
+    float threshold = -18.0f;        // dB
+    float ratio = 3.0f;
+    float attack = 1.0f;             // ms
+    float release = 30.0f;           // ms
+    float knee = 2.0f;               // dB
+
+    // [Limiter]
+    bool limiterEnabled = true;
+    float ceiling = -1.0f;           // dB
+    float lookahead = 3.0f;          // ms
+    float limiterRelease = 30.0f;    // ms
+
+    // [Output]
+    float outputGainDb = 0.0f;       // dB
+    float makeupGain = 0.0f;         // dB
+
+    // Gains are stored in dB, as in the .preset files, so none can be zero
+    float getInputGain() const noexcept  { return juce::Decibels::decibelsToGain(inputGainDb); }
+    float getOutputGain() const noexcept { return juce::Decibels::decibelsToGain(outputGainDb); }
+
+    // Parses the INI-style preset text. Unknown sections and keys are ignored,
+    // missing keys keep their current value, out-of-range values are clamped
+    // with a warning in the log.
+    void parse(const juce::String& presetText);
+
+    // Returns false (and logs why) if the file is missing or empty
+    bool loadFromFile(const juce::File& presetFile);
+};
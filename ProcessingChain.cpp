@@ -0,0 +1,162 @@
+#include "ProcessingChain.h"
+#include "StageTimer.h"
+
+//==============================================================================
+ProcessingChain::ProcessingChain()
+{
+    for (auto& enabled : stageEnabled)
+        enabled.store(true);
+
+    setStageEnabled(autoGainStage, false);
+}
+
+ProcessingChain::~ProcessingChain()
+{
+    releaseResources();
+}
+
+void ProcessingChain::prepareToPlay(double newSampleRate, int samplesPerBlock, int numChannels)
+{
+    sampleRate = newSampleRate;
+
+    noiseGate.prepareToPlay(sampleRate, samplesPerBlock);
+    autoGain.prepareToPlay(sampleRate, samplesPerBlock, numChannels);
+    compressor.prepareToPlay(sampleRate, samplesPerBlock);
+    limiter.prepareToPlay(sampleRate, samplesPerBlock, numChannels);
+    outputGain.prepare(sampleRate, samplesPerBlock, gainRampSeconds);
+    isFreshlyPrepared = true;
+
+    gateReduction = 0.0f;
+    autoGainDb = 0.0f;
+    compressorReduction = 0.0f;
+    limiterReduction = 0.0f;
+}
+
+void ProcessingChain::processBlock(juce::dsp::AudioBlock<float>& audioBlock)
+{
+    {
+        STAGE_TIMER_SCOPE(gate, static_cast<int>(audioBlock.getNumSamples()));
+        gateReduction = isStageEnabled(gateStage) ? noiseGate.processBlock(audioBlock) : 0.0f;
+    }
+
+    {
+        STAGE_TIMER_SCOPE(autoGain, static_cast<int>(audioBlock.getNumSamples()));
+        autoGainDb = isStageEnabled(autoGainStage) ? autoGain.processBlock(audioBlock) : 0.0f;
+    }
+
+    // The compressor times its detector and gain stages itself
+    compressorReduction = isStageEnabled(compressorStage) ? compressor.processBlock(audioBlock) : 0.0f;
+
+    {
+        STAGE_TIMER_SCOPE(limiter, static_cast<int>(audioBlock.getNumSamples()));
+        limiterReduction = isStageEnabled(limiterStage) ? limiter.processBlock(audioBlock) : 0.0f;
+    }
+
+    if (isStageEnabled(outputGainStage))
+    {
+        STAGE_TIMER_SCOPE(outputGain, static_cast<int>(audioBlock.getNumSamples()));
+        outputGain.applyGain(audioBlock);
+    }
+
+    isFreshlyPrepared = false;
+}
+
+void ProcessingChain::releaseResources()
+{
+    noiseGate.releaseResources();
+    autoGain.releaseResources();
+    compressor.releaseResources();
+    limiter.releaseResources();
+}
+
+//==============================================================================
+void ProcessingChain::setStageEnabled(Stage stage, bool shouldBeEnabled)
+{
+    stageEnabled[static_cast<size_t>(stage)].store(shouldBeEnabled);
+}
+
+void ProcessingChain::setOutputGain(float gainLinear)
+{
+    if (isFreshlyPrepared)
+        outputGain.setCurrentAndTargetValue(gainLinear);
+    else
+        outputGain.setTargetValue(gainLinear);
+}
+
+bool ProcessingChain::setParameters(const Parameters& newParameters)
+{
+    // Published before a sample rate change reached the publisher, which
+    // publishes again for the new rate; deriving here would run every
+    // stage's std::exp on the audio thread
+    if (newParameters.sampleRate != sampleRate)
+        return false;
+
+    noiseGate.setParameters(newParameters.gate);
+    autoGain.setParameters(newParameters.autoGain);
+    compressor.setParameters(newParameters.compressor);
+    limiter.setParameters(newParameters.limiter);
+    setOutputGain(newParameters.outputGain);
+
+    for (size_t stage = 0; stage < stageEnabled.size(); ++stage)
+        stageEnabled[stage].store(newParameters.stageEnabled[stage]);
+
+    return true;
+}
+
+void ProcessingChain::applySettings(const PresetSettings& settings)
+{
+    auto newParameters = Parameters::fromSettings(settings);
+    newParameters.prepare(sampleRate);
+    setParameters(newParameters);
+}
+
+int ProcessingChain::getLatencySamples() const
+{
+    return isStageEnabled(limiterStage) ? limiter.getLatencySamples() : 0;
+}
+
+//==============================================================================
+void ProcessingChain::Parameters::prepare(double sampleRateToUse)
+{
+    sampleRate = sampleRateToUse;
+
+    gate.prepare(sampleRate);
+    autoGain.prepare(sampleRate);
+    compressor.prepare(sampleRate);
+    limiter.prepare(sampleRate);
+}
+
+ProcessingChain::Parameters ProcessingChain::Parameters::fromSettings(const PresetSettings& settings)
+{
+    Parameters parameters;
+
+    parameters.gate.threshold = settings.gateThreshold;
+    parameters.gate.ratio = settings.gateRatio;
+    parameters.gate.attack = settings.gateAttack;
+    parameters.gate.release = settings.gateRelease;
+
+    parameters.autoGain.targetLoudness = settings.autoGainTarget;
+    parameters.autoGain.maxBoost = settings.autoGainMaxBoost;
+
+    parameters.compressor.threshold = settings.threshold;
+    parameters.compressor.ratio = settings.ratio;
+    parameters.compressor.attack = settings.attack;
+    parameters.compressor.release = settings.release;
+    parameters.compressor.knee = settings.knee;
+    parameters.compressor.makeupGain = settings.makeupGain;
+    parameters.compressor.autoMakeupGain = false;
+
+    parameters.limiter.ceiling = settings.ceiling;
+    parameters.limiter.lookahead = settings.lookahead;
+    parameters.limiter.release = settings.limiterRelease;
+
+    parameters.outputGain = settings.getOutputGain();
+
+    parameters.stageEnabled[gateStage] = settings.gateEnabled;
+    parameters.stageEnabled[autoGainStage] = settings.autoGainEnabled;
+    parameters.stageEnabled[compressorStage] = settings.compressorEnabled;
+    parameters.stageEnabled[limiterStage] = settings.limiterEnabled;
+    parameters.stageEnabled[outputGainStage] = true;
+
+    return parameters;
+}
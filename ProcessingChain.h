@@ -0,0 +1,105 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "NoiseGate.h"
+#include "AutoGain.h"
+#include "Compressor.h"
+#include "Limiter.h"
+#include "GainRamp.h"
+#include "PresetSettings.h"
+
+//==============================================================================
+// Ordered realtime DSP chain: gate -> auto gain -> compressor -> limiter ->
+// output gain. All stages are prepared up front and work in place on the
+// block, so processBlock never allocates. Disabled stages are skipped
+// entirely. Auto gain starts disabled; everything else starts enabled.
+// Output gain changes are ramped; the first parameters after prepareToPlay
+// are applied without a ramp.
+class ProcessingChain
+{
+public:
+    enum Stage
+    {
+        gateStage,
+        autoGainStage,
+        compressorStage,
+        limiterStage,
+        outputGainStage,
+        numStages
+    };
+
+    // Everything the chain needs in one value, with all coefficients already
+    // derived by prepare(). Built and prepared off the audio thread, then
+    // handed over whole, so the audio thread never sees a half-applied set.
+    struct Parameters
+    {
+        NoiseGate::Parameters gate;
+        AutoGain::Parameters autoGain;
+        Compressor::Parameters compressor;
+        Limiter::Parameters limiter;
+        float outputGain = 1.0f;         // linear
+        std::array<bool, numStages> stageEnabled { true, false, true, true, true };
+
+        double sampleRate = 0.0;         // rate the coefficients were derived for
+
+        void prepare(double sampleRateToUse);
+        static Parameters fromSettings(const PresetSettings& settings);
+    };
+
+    ProcessingChain();
+    ~ProcessingChain();
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
+    void processBlock(juce::dsp::AudioBlock<float>& audioBlock);
+    void releaseResources();
+
+    // Stage control (safe to call from any thread)
+    void setStageEnabled(Stage stage, bool shouldBeEnabled);
+    bool isStageEnabled(Stage stage) const { return stageEnabled[static_cast<size_t>(stage)].load(); }
+
+    // Ramps to the new output gain (audio thread, or before processing starts)
+    void setOutputGain(float gainLinear);
+
+    // Copies a prepared parameter set into the stages (no maths, no
+    // allocation). A set prepared for another rate is ignored and false is
+    // returned; the current parameters stay until one for this rate arrives.
+    bool setParameters(const Parameters& newParameters);
+
+    // Pushes every stage parameter and switch from a preset. Input gain is
+    // left to the caller, which applies it before the chain.
+    void applySettings(const PresetSettings& settings);
+
+    // Stage access for parameter updates
+    NoiseGate& getNoiseGate() { return noiseGate; }
+    AutoGain& getAutoGain() { return autoGain; }
+    Compressor& getCompressor() { return compressor; }
+    Limiter& getLimiter() { return limiter; }
+
+    // Metering (written by processBlock)
+    float getGateReduction() const { return gateReduction; }
+    float getGainReduction() const { return compressorReduction + limiterReduction; }
+    float getAutoGainDb() const { return autoGainDb; }
+    int getLatencySamples() const;
+
+private:
+    NoiseGate noiseGate;
+    AutoGain autoGain;
+    Compressor compressor;
+    Limiter limiter;
+    GainRamp outputGain;
+    bool isFreshlyPrepared = true;
+    double sampleRate = 44100.0;
+
+    static constexpr double gainRampSeconds = 0.02;
+
+    std::array<std::atomic<bool>, numStages> stageEnabled;
+
+    float gateReduction = 0.0f;
+    float autoGainDb = 0.0f;
+    float compressorReduction = 0.0f;
+    float limiterReduction = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessingChain)
+};
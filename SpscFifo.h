@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+// Wait-free single-producer / single-consumer FIFO index manager.
+//
+// Works like juce::AbstractFifo (it hands out index ranges; the caller owns
+// the storage) but never needs a lock around it: capacity is a power of two,
+// the read and write positions are free-running counters on separate cache
+// lines, and each side publishes its position with a release store that the
+// other side picks up with an acquire load.
+//
+// Overrun/underrun counters are plain atomics so a UI can poll them.
+class SpscFifo
+{
+public:
+    struct Region
+    {
+        int start1 = 0, size1 = 0;
+        int start2 = 0, size2 = 0;
+
+        int getTotalSize() const noexcept { return size1 + size2; }
+    };
+
+    explicit SpscFifo(int minimumCapacity = 0)
+    {
+        setCapacity(minimumCapacity);
+    }
+
+    // Not thread-safe: only call while neither side is running
+    void setCapacity(int minimumCapacity)
+    {
+        capacity = minimumCapacity > 0 ? juce::nextPowerOfTwo(minimumCapacity) : 0;
+        mask = capacity > 0 ? static_cast<uint32_t>(capacity - 1) : 0;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        writePosition.store(0);
+        readPosition.store(0);
+    }
+
+    int getCapacity() const noexcept { return capacity; }
+
+    //==============================================================================
+    // Producer side
+    int getFreeSpace() const noexcept
+    {
+        const auto write = writePosition.load(std::memory_order_relaxed);
+        const auto read = readPosition.load(std::memory_order_acquire);
+        return capacity - static_cast<int>(write - read);
+    }
+
+    Region prepareToWrite(int numWanted) const noexcept
+    {
+        return makeRegion(writePosition.load(std::memory_order_relaxed),
+                          juce::jmin(numWanted, getFreeSpace()));
+    }
+
+    void finishedWrite(int numWritten) noexcept
+    {
+        const auto write = writePosition.load(std::memory_order_relaxed);
+        writePosition.store(write + static_cast<uint32_t>(numWritten), std::memory_order_release);
+    }
+
+    //==============================================================================
+    // Consumer side
+    int getNumReady() const noexcept
+    {
+        const auto read = readPosition.load(std::memory_order_relaxed);
+        const auto write = writePosition.load(std::memory_order_acquire);
+        return static_cast<int>(write - read);
+    }
+
+    Region prepareToRead(int numWanted) const noexcept
+    {
+        return makeRegion(readPosition.load(std::memory_order_relaxed),
+                          juce::jmin(numWanted, getNumReady()));
+    }
+
+    void finishedRead(int numRead) noexcept
+    {
+        const auto read = readPosition.load(std::memory_order_relaxed);
+        readPosition.store(read + static_cast<uint32_t>(numRead), std::memory_order_release);
+    }
+
+    //==============================================================================
+    // Status counters (any thread)
+    void reportOverrun() noexcept   { overruns.fetch_add(1, std::memory_order_relaxed); }
+    void reportUnderrun() noexcept  { underruns.fetch_add(1, std::memory_order_relaxed); }
+
+    uint32_t getOverrunCount() const noexcept  { return overruns.load(std::memory_order_relaxed); }
+    uint32_t getUnderrunCount() const noexcept { return underruns.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t cacheLineSize = 64;
+
+    alignas(cacheLineSize) std::atomic<uint32_t> writePosition { 0 };
+    alignas(cacheLineSize) std::atomic<uint32_t> readPosition { 0 };
+    alignas(cacheLineSize) std::atomic<uint32_t> overruns { 0 };
+    std::atomic<uint32_t> underruns { 0 };
+
+    alignas(cacheLineSize) int capacity = 0;
+    uint32_t mask = 0;
+
+    Region makeRegion(uint32_t position, int numItems) const noexcept
+    {
+        Region region;
+        region.start1 = static_cast<int>(position & mask);
+        region.size1 = juce::jmin(numItems, capacity - region.start1);
+        region.size2 = numItems - region.size1;
+        return region;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(SpscFifo)
+};
@@ -0,0 +1,268 @@
+#include "StageTimer.h"
+#include <limits>
+#include <vector>
+
+#if AUDIOPROCESSOR_STAGE_TIMING
+namespace
+{
+    constexpr int maxThreads = 16;
+    constexpr int eventsPerThread = 8192;   // power of two
+    constexpr uint64_t eventMask = eventsPerThread - 1;
+
+    struct Event
+    {
+        juce::int64 startTicks;
+        juce::int64 durationTicks;
+        int32_t samples;
+        int32_t stage;
+    };
+
+    // One per thread that has run a scope; written by that thread only
+    struct alignas(64) Slot
+    {
+        std::atomic<bool> claimed { false };
+        std::array<std::atomic<uint64_t>, StageTimer::numStages> calls {};
+        std::array<std::atomic<uint64_t>, StageTimer::numStages> samples {};
+        std::array<std::atomic<uint64_t>, StageTimer::numStages> ticks {};
+        std::array<Event, eventsPerThread> events {};
+        std::atomic<uint64_t> numEvents { 0 };
+    };
+
+    std::array<Slot, maxThreads> slots;
+
+    // Claimed on a thread's first scope and handed back when the thread exits;
+    // threads beyond maxThreads go untimed
+    struct SlotClaim
+    {
+        SlotClaim() noexcept
+        {
+            for (auto& candidate : slots)
+            {
+                bool expected = false;
+
+                if (candidate.claimed.compare_exchange_strong(expected, true))
+                {
+                    slot = &candidate;
+                    break;
+                }
+            }
+        }
+
+        ~SlotClaim()
+        {
+            if (slot != nullptr)
+                slot->claimed.store(false);
+        }
+
+        Slot* slot = nullptr;
+    };
+
+    Slot* getThreadSlot() noexcept
+    {
+        thread_local SlotClaim claim;
+        return claim.slot;
+    }
+
+    template <typename T>
+    void addTo(std::atomic<T>& counter, T amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+#endif
+
+//==============================================================================
+const char* StageTimer::getStageName(int stage) noexcept
+{
+    switch (stage)
+    {
+        case callback:              return "callback";
+        case inputGain:             return "inputGain";
+        case gate:                  return "gate";
+        case autoGain:              return "autoGain";
+        case compressorDetector:    return "compressorDetector";
+        case compressorGain:        return "compressorGain";
+        case limiter:               return "limiter";
+        case outputGain:            return "outputGain";
+        case loudnessMeter:         return "loudnessMeter";
+        case virtualDevice:         return "virtualDevice";
+        default:                    break;
+    }
+
+    return "unknown";
+}
+
+StageTimer::Scope::Scope(Stage stageToTime, int numSamples) noexcept
+    : stage(stageToTime),
+      samples(numSamples),
+      startTicks(juce::Time::getHighResolutionTicks())
+{
+}
+
+StageTimer::Scope::~Scope() noexcept
+{
+   #if AUDIOPROCESSOR_STAGE_TIMING
+    const auto durationTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    auto* slot = getThreadSlot();
+
+    if (slot == nullptr)
+        return;
+
+    const auto index = static_cast<size_t>(stage);
+    addTo(slot->calls[index], uint64_t { 1 });
+    addTo(slot->samples[index], static_cast<uint64_t>(samples));
+    addTo(slot->ticks[index], static_cast<uint64_t>(durationTicks));
+
+    const auto eventNumber = slot->numEvents.load(std::memory_order_relaxed);
+    slot->events[eventNumber & eventMask] = { startTicks, durationTicks, samples, static_cast<int32_t>(stage) };
+    slot->numEvents.store(eventNumber + 1, std::memory_order_release);
+   #endif
+}
+
+//==============================================================================
+StageTimer::Snapshot StageTimer::getSnapshot()
+{
+    Snapshot snapshot;
+
+   #if AUDIOPROCESSOR_STAGE_TIMING
+    for (const auto& slot : slots)
+    {
+        for (size_t stage = 0; stage < snapshot.size(); ++stage)
+        {
+            snapshot[stage].calls += slot.calls[stage].load(std::memory_order_relaxed);
+            snapshot[stage].samples += slot.samples[stage].load(std::memory_order_relaxed);
+            snapshot[stage].seconds += juce::Time::highResolutionTicksToSeconds(
+                                           static_cast<juce::int64>(slot.ticks[stage].load(std::memory_order_relaxed)));
+        }
+    }
+   #endif
+
+    return snapshot;
+}
+
+StageTimer::Snapshot StageTimer::getDifference(const Snapshot& later, const Snapshot& earlier)
+{
+    Snapshot difference;
+
+    for (size_t stage = 0; stage < difference.size(); ++stage)
+    {
+        difference[stage].calls = later[stage].calls - earlier[stage].calls;
+        difference[stage].samples = later[stage].samples - earlier[stage].samples;
+        difference[stage].seconds = later[stage].seconds - earlier[stage].seconds;
+    }
+
+    return difference;
+}
+
+juce::String StageTimer::toString(const Snapshot& snapshot)
+{
+    juce::StringArray parts;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        if (snapshot[static_cast<size_t>(stage)].calls > 0)
+            parts.add(juce::String(getStageName(stage)) + " "
+                      + juce::String(snapshot[static_cast<size_t>(stage)].getNanosecondsPerSample(), 2));
+
+    return parts.isEmpty() ? juce::String("no stage timings")
+                           : parts.joinIntoString(", ") + " ns/sample";
+}
+
+//==============================================================================
+juce::Result StageTimer::writeChromeTrace(const juce::File& file, int numCallbacks)
+{
+   #if AUDIOPROCESSOR_STAGE_TIMING
+    struct ThreadEvents
+    {
+        int thread;
+        std::vector<Event> events;
+    };
+
+    std::vector<ThreadEvents> threads;
+    auto earliestTicks = std::numeric_limits<juce::int64>::max();
+
+    for (int thread = 0; thread < maxThreads; ++thread)
+    {
+        const auto& slot = slots[static_cast<size_t>(thread)];
+        const auto count = slot.numEvents.load(std::memory_order_acquire);
+        const auto available = juce::jmin(count, static_cast<uint64_t>(eventsPerThread));
+
+        if (available == 0)
+            continue;
+
+        // Newest first, stopping once numCallbacks whole callbacks are in
+        std::vector<Event> events;
+        events.reserve(static_cast<size_t>(available));
+        int callbacksSeen = 0;
+
+        for (uint64_t back = 0; back < available; ++back)
+        {
+            const auto& event = slot.events[(count - 1 - back) & eventMask];
+
+            if (event.stage == callback && ++callbacksSeen > numCallbacks)
+                break;
+
+            events.push_back(event);
+        }
+
+        // Drop what the audio thread may have overwritten while we copied
+        const auto countAfter = slot.numEvents.load(std::memory_order_acquire);
+        const auto oldestIntact = countAfter >= static_cast<uint64_t>(eventsPerThread)
+                                      ? countAfter - eventsPerThread + 1 : 0;
+
+        while (!events.empty() && count - events.size() < oldestIntact)
+            events.pop_back();
+
+        for (const auto& event : events)
+            earliestTicks = juce::jmin(earliestTicks, event.startTicks);
+
+        threads.push_back({ thread, std::move(events) });
+    }
+
+    juce::Array<juce::var> traceEvents;
+
+    for (const auto& thread : threads)
+    {
+        auto* metadata = new juce::DynamicObject();
+        metadata->setProperty("name", "thread_name");
+        metadata->setProperty("ph", "M");
+        metadata->setProperty("pid", 1);
+        metadata->setProperty("tid", thread.thread);
+
+        auto* threadName = new juce::DynamicObject();
+        threadName->setProperty("name", "audio thread " + juce::String(thread.thread));
+        metadata->setProperty("args", juce::var(threadName));
+        traceEvents.add(juce::var(metadata));
+
+        // Oldest first reads more naturally in the file
+        for (auto it = thread.events.rbegin(); it != thread.events.rend(); ++it)
+        {
+            auto* event = new juce::DynamicObject();
+            event->setProperty("name", getStageName(it->stage));
+            event->setProperty("cat", "dsp");
+            event->setProperty("ph", "X");
+            event->setProperty("ts", juce::Time::highResolutionTicksToSeconds(it->startTicks - earliestTicks) * 1.0e6);
+            event->setProperty("dur", juce::Time::highResolutionTicksToSeconds(it->durationTicks) * 1.0e6);
+            event->setProperty("pid", 1);
+            event->setProperty("tid", thread.thread);
+
+            auto* args = new juce::DynamicObject();
+            args->setProperty("samples", it->samples);
+            event->setProperty("args", juce::var(args));
+
+            traceEvents.add(juce::var(event));
+        }
+    }
+
+    auto* trace = new juce::DynamicObject();
+    trace->setProperty("traceEvents", traceEvents);
+    trace->setProperty("displayTimeUnit", "ns");
+
+    if (!file.replaceWithText(juce::JSON::toString(juce::var(trace), true, 3)))
+        return juce::Result::fail("Cannot write " + file.getFullPathName());
+
+    return juce::Result::ok();
+   #else
+    juce::ignoreUnused(file, numCallbacks);
+    return juce::Result::fail("Stage timing is not compiled in (configure with -DAUDIOPROCESSOR_STAGE_TIMING=ON)");
+   #endif
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+#ifndef AUDIOPROCESSOR_STAGE_TIMING
+ #define AUDIOPROCESSOR_STAGE_TIMING 0
+#endif
+
+//==============================================================================
+// Per-stage timing of the DSP path, compiled in with
+// -DAUDIOPROCESSOR_STAGE_TIMING=ON (CMake) and compiled out otherwise.
+//
+// STAGE_TIMER_SCOPE(stage, numSamples) times the rest of the enclosing scope.
+// Each thread that runs a scope claims one of a fixed set of slots on first
+// use; the slot holds that thread's per-stage totals and a ring of the most
+// recent timing events, so the hot path never allocates, locks or shares a
+// cache line with another audio thread.
+//
+// getSnapshot() sums the totals over all threads (ns/sample per stage), and
+// writeChromeTrace() dumps the events of the last N callbacks as a Chrome
+// trace-event file for chrome://tracing or Perfetto. Events still being
+// overwritten while a dump runs are dropped, not torn.
+class StageTimer
+{
+public:
+    enum Stage
+    {
+        callback,               // a whole engine callback, the parent of the others
+        inputGain,
+        gate,
+        autoGain,
+        compressorDetector,
+        compressorGain,
+        limiter,
+        outputGain,
+        loudnessMeter,
+        virtualDevice,
+        numStages
+    };
+
+    static const char* getStageName(int stage) noexcept;
+    static constexpr bool isCompiledIn() noexcept { return AUDIOPROCESSOR_STAGE_TIMING != 0; }
+
+    //==============================================================================
+    class Scope
+    {
+    public:
+        Scope(Stage stageToTime, int numSamples) noexcept;
+        ~Scope() noexcept;
+
+    private:
+        Stage stage;
+        int samples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    //==============================================================================
+    struct StageTotals
+    {
+        uint64_t calls = 0;
+        uint64_t samples = 0;
+        double seconds = 0.0;
+
+        double getNanosecondsPerSample() const noexcept { return samples > 0 ? seconds * 1.0e9 / static_cast<double>(samples) : 0.0; }
+    };
+
+    using Snapshot = std::array<StageTotals, numStages>;
+
+    // Totals since startup over all threads; diff two snapshots for an interval
+    static Snapshot getSnapshot();
+    static Snapshot getDifference(const Snapshot& later, const Snapshot& earlier);
+    static juce::String toString(const Snapshot& snapshot);
+
+    // Events of the last numCallbacks callbacks of every thread
+    static juce::Result writeChromeTrace(const juce::File& file, int numCallbacks);
+};
+
+#if AUDIOPROCESSOR_STAGE_TIMING
+ #define STAGE_TIMER_SCOPE(stage, numSamples) \
+    const StageTimer::Scope JUCE_JOIN_MACRO(stageTimerScope_, __LINE__) (StageTimer::stage, numSamples)
+#else
+ #define STAGE_TIMER_SCOPE(stage, numSamples)
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+// Lock-free single-writer / single-reader triple buffer for whole-object
+// snapshots (parameter sets and the like).
+//
+// The writer fills getWriteBuffer() and calls publish(); the reader calls
+// update() once per block and, if it returns true, uses getReadBuffer().
+// Each side owns one of the three slots and the third is handed over with a
+// single atomic exchange, so the reader always sees a complete snapshot,
+// never waits, and only the newest publish survives.
+//
+// Only one thread may write and one may read at a time; serialise multiple
+// non-realtime writers externally.
+template <typename ValueType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    //==============================================================================
+    // Writer side
+    ValueType& getWriteBuffer() noexcept { return slots[static_cast<size_t>(writeSlot)]; }
+
+    void publish() noexcept
+    {
+        const int previous = sharedSlot.exchange(writeSlot | newDataFlag, std::memory_order_acq_rel);
+        writeSlot = previous & slotMask;
+    }
+
+    //==============================================================================
+    // Reader side: returns true if a newer snapshot was picked up
+    bool update() noexcept
+    {
+        if ((sharedSlot.load(std::memory_order_relaxed) & newDataFlag) == 0)
+            return false;
+
+        const int previous = sharedSlot.exchange(readSlot, std::memory_order_acq_rel);
+        readSlot = previous & slotMask;
+        return true;
+    }
+
+    const ValueType& getReadBuffer() const noexcept { return slots[static_cast<size_t>(readSlot)]; }
+
+private:
+    static constexpr int slotMask = 3;
+    static constexpr int newDataFlag = 4;
+
+    std::array<ValueType, 3> slots {};
+
+    int writeSlot = 0;
+    alignas(64) std::atomic<int> sharedSlot { 1 };
+    alignas(64) int readSlot = 2;
+
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
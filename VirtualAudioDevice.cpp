@@ -1,7 +1,8 @@
 #include "VirtualAudioDevice.h"
 
 //==============================================================================
-VirtualAudioDevice::VirtualAudioDevice()
+VirtualAudioDevice::VirtualAudioDevice(int numOutputChannels)
+    : numChannels(juce::jmax(1, numOutputChannels))
 {
     initializePlatformSpecific();
 }
@@ -84,6 +85,110 @@ void VirtualAudioDevice::setActive(bool shouldBeActive)
     DBG("VirtualAudioDevice " + juce::String(shouldBeActive ? "activated" : "deactivated"));
 }
 
+uint32_t VirtualAudioDevice::getOverrunCount() const
+{
+#if JUCE_LINUX
+    return linuxDevice ? linuxDevice->getOverrunCount() : 0;
+#else
+    return 0;
+#endif
+}
+
+uint32_t VirtualAudioDevice::getUnderrunCount() const
+{
+#if JUCE_LINUX
+    return linuxDevice ? linuxDevice->getUnderrunCount() : 0;
+#else
+    return 0;
+#endif
+}
+
+float VirtualAudioDevice::getClockDriftPpm() const
+{
+#if JUCE_LINUX
+    return linuxDevice ? linuxDevice->getClockDriftPpm() : 0.0f;
+#else
+    return 0.0f;
+#endif
+}
+
+CallbackProfiler* VirtualAudioDevice::getProfiler()
+{
+#if JUCE_LINUX
+    return linuxDevice ? &linuxDevice->getProfiler() : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+int VirtualAudioDevice::getLatencySamples() const
+{
+#if JUCE_LINUX
+    return linuxDevice ? linuxDevice->getLatencySamples() : 0;
+#else
+    return 0;
+#endif
+}
+
+bool VirtualAudioDevice::setNativeCallback(juce::AudioIODeviceCallback* callback)
+{
+#if JUCE_LINUX
+    if (!linuxDevice)
+        return false;
+    
+    linuxDevice->setNativeCallback(callback);
+    return true;
+#else
+    juce::ignoreUnused(callback);
+    return false;
+#endif
+}
+
+bool VirtualAudioDevice::isNativeMode() const
+{
+#if JUCE_LINUX
+    return linuxDevice && linuxDevice->isNativeMode();
+#else
+    return false;
+#endif
+}
+
+double VirtualAudioDevice::getSampleRate() const
+{
+#if JUCE_LINUX
+    if (linuxDevice)
+        return static_cast<double>(linuxDevice->getSampleRate());
+#endif
+    return currentSampleRate;
+}
+
+int VirtualAudioDevice::getBufferSize() const
+{
+#if JUCE_LINUX
+    if (linuxDevice)
+        return linuxDevice->getBufferSize();
+#endif
+    return currentBlockSize;
+}
+
+void VirtualAudioDevice::setFormatChangedCallback(std::function<void(double, int)> callback)
+{
+#if JUCE_LINUX
+    if (linuxDevice)
+    {
+        if (callback)
+            linuxDevice->setFormatChangedCallback([cb = std::move(callback)](int sampleRate, int bufferSize)
+            {
+                cb(static_cast<double>(sampleRate), bufferSize);
+            });
+        else
+            linuxDevice->setFormatChangedCallback(nullptr);
+    }
+#else
+    juce::ignoreUnused(callback);
+#endif
+}
+
 //==============================================================================
 // Platform-specific implementations
 
@@ -91,7 +196,7 @@ void VirtualAudioDevice::initializePlatformSpecific()
 {
 #if JUCE_LINUX
     DBG("Initializing Linux virtual audio device");
-    linuxDevice = std::make_unique<VirtualAudioDevice_Linux>();
+    linuxDevice = std::make_unique<VirtualAudioDevice_Linux>(numChannels);
     
     if (linuxDevice->initialize(deviceName))
     {
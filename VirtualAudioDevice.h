@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "CallbackProfiler.h"
 
 #if JUCE_LINUX
 #include "VirtualAudioDevice_Linux.h"
@@ -10,7 +11,7 @@
 class VirtualAudioDevice
 {
 public:
-    VirtualAudioDevice();
+    explicit VirtualAudioDevice(int numOutputChannels = 2);
     ~VirtualAudioDevice();
     
     void prepareToPlay(double sampleRate, int samplesPerBlock);
@@ -20,14 +21,43 @@ public:
     // Device management
     bool isAvailable() const;
     juce::String getDeviceName() const { return deviceName; }
+    int getNumChannels() const { return numChannels; }
     
     // Status
     bool isActive() const;
     void setActive(bool shouldBeActive);
     
+    // FIFO health counters (lock-free)
+    uint32_t getOverrunCount() const;
+    uint32_t getUnderrunCount() const;
+    
+    // Resampling correction the device applies against our clock, in ppm
+    float getClockDriftPpm() const;
+    
+    // Timing of the device's own audio callback, or nullptr where there is none
+    CallbackProfiler* getProfiler();
+    
+    // Frames queued between processAudioBlock() and the device outputs
+    // (just the device period in native mode)
+    int getLatencySamples() const;
+    
+    // Native mode: the device's own thread runs the callback on its input
+    // and writes the result to its outputs, bypassing processAudioBlock().
+    // Returns false where the platform has no native mode. Prepare the
+    // callback for getSampleRate() / getBufferSize() before enabling it.
+    bool setNativeCallback(juce::AudioIODeviceCallback* callback);
+    bool isNativeMode() const;
+    double getSampleRate() const;
+    int getBufferSize() const;
+    
+    // Called from a device-owned, non-realtime thread after the platform
+    // changed its sample rate or period, e.g. to re-prepare a native callback
+    void setFormatChangedCallback(std::function<void(double sampleRate, int bufferSize)> callback);
+    
 private:
     // Device state
     juce::String deviceName = "Audio Processor Virtual Device";
+    const int numChannels;
     
     // Audio parameters
     double currentSampleRate = 44100.0;
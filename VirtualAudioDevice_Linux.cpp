@@ -1,16 +1,26 @@
 #include "VirtualAudioDevice_Linux.h"
 
 //==============================================================================
-VirtualAudioDevice_Linux::VirtualAudioDevice_Linux()
-    : audioFifo(2048) // 2048 sample FIFO buffer
+VirtualAudioDevice_Linux::Ring::Ring(int numLanes, int minimumCapacity)
+    : fifo(minimumCapacity),
+      lanes(numLanes, fifo.getCapacity())
 {
-    fifoBuffer = std::make_unique<float[]>(2048 * 2); // Stereo buffer
-    audioBuffer.setSize(2, 512); // Default buffer size
+    lanes.clear();
+}
+
+VirtualAudioDevice_Linux::VirtualAudioDevice_Linux(int numOutputChannels)
+    : juce::Thread("JACK reconfiguration"),
+      numChannels(juce::jmax(1, numOutputChannels))
+{
+    outputPorts.reserve(static_cast<size_t>(numChannels));
+    outputChannels.resize(static_cast<size_t>(numChannels), nullptr);
+    driftCompensator.prepare(numChannels, driftChunkSize);
 }
 
 VirtualAudioDevice_Linux::~VirtualAudioDevice_Linux()
 {
     shutdown();
+    stopThread(1000);
 }
 
 bool VirtualAudioDevice_Linux::initialize(const juce::String& deviceName)
@@ -42,10 +52,22 @@ bool VirtualAudioDevice_Linux::initialize(const juce::String& deviceName)
     }
     
     // Get JACK audio parameters
-    sampleRate = jack_get_sample_rate(jackClient);
-    bufferSize = jack_get_buffer_size(jackClient);
+    sampleRate.store(static_cast<int>(jack_get_sample_rate(jackClient)));
+    bufferSize.store(static_cast<int>(jack_get_buffer_size(jackClient)));
     
-    DBG("JACK parameters: " + juce::String(sampleRate) + " Hz, " + juce::String(bufferSize) + " samples");
+    requestedSampleRate.store(sampleRate.load());
+    requestedBufferSize.store(bufferSize.load());
+    profiler.prepare(sampleRate.load());
+    
+    DBG("JACK parameters: " + juce::String(sampleRate.load()) + " Hz, " + juce::String(bufferSize.load()) + " samples");
+    
+    // First ring, sized for the current period
+    if (rings.isEmpty())
+    {
+        auto* ring = rings.add(new Ring(numChannels, getRingCapacity(bufferSize.load(), 0)));
+        readRing = ring;
+        writeRing.store(ring);
+    }
     
     // Activate JACK client
     if (!activateJackClient())
@@ -56,6 +78,7 @@ bool VirtualAudioDevice_Linux::initialize(const juce::String& deviceName)
     }
     
     initialized.store(true);
+    startThread();
     DBG("Linux virtual audio device initialized successfully");
     return true;
 }
@@ -67,8 +90,10 @@ void VirtualAudioDevice_Linux::shutdown()
     
     DBG("Shutting down Linux virtual audio device");
     
+    setNativeCallback(nullptr);
     setActive(false);
     deactivateJackClient();
+    stopThread(1000);
     
     if (jackClient)
     {
@@ -77,7 +102,7 @@ void VirtualAudioDevice_Linux::shutdown()
     }
     
     inputPort = nullptr;
-    outputPort = nullptr;
+    outputPorts.clear();
     initialized.store(false);
     
     DBG("Linux virtual audio device shut down");
@@ -94,51 +119,212 @@ void VirtualAudioDevice_Linux::processAudioBlock(const juce::AudioBuffer<float>&
     if (!active.load() || !initialized.load())
         return;
     
-    // Write audio data to FIFO for JACK thread to consume
-    juce::ScopedLock lock(bufferLock);
+    // Write audio data to FIFO for JACK thread to consume (producer side, no lock).
+    // The in-use flag and the last finished ring tell the JACK thread when
+    // no more blocks can land in a ring it wants to leave.
+    producerInUse.store(true);
+    auto& ring = *writeRing.load();
+    
+    // Single producer: a plain load/store is enough to track the maximum
+    if (numSamples > producerBlockSize.load(std::memory_order_relaxed))
+        producerBlockSize.store(numSamples, std::memory_order_relaxed);
+    
+    const int numSourceChannels = buffer.getNumChannels();
+    const auto region = ring.fifo.prepareToWrite(numSamples);
+    const int samplesToWrite = region.getTotalSize();
     
-    const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
-    const int availableSpace = audioFifo.getFreeSpace();
-    const int samplesToWrite = juce::jmin(numSamples, availableSpace);
+    if (samplesToWrite < numSamples)
+        overruns.fetch_add(1, std::memory_order_relaxed);
     
     if (samplesToWrite > 0)
     {
-        int start1, size1, start2, size2;
-        audioFifo.prepareToWrite(samplesToWrite, start1, size1, start2, size2);
-        
-        // Interleave audio data into FIFO buffer
         for (int channel = 0; channel < numChannels; ++channel)
         {
-            const float* channelData = buffer.getReadPointer(channel, startSample);
+            // A mono source feeds both sides of the first pair; other unmatched lanes are silent
+            const int sourceChannel = channel < numSourceChannels ? channel
+                                    : (numSourceChannels == 1 && channel == 1 ? 0 : -1);
+            float* lane = ring.lanes.getWritePointer(channel);
             
-            // Write first block
-            for (int i = 0; i < size1; ++i)
+            if (sourceChannel < 0)
             {
-                fifoBuffer[(start1 + i) * 2 + channel] = channelData[i];
+                juce::FloatVectorOperations::clear(lane + region.start1, region.size1);
+                juce::FloatVectorOperations::clear(lane + region.start2, region.size2);
+                continue;
             }
             
-            // Write second block (if wrapping)
-            for (int i = 0; i < size2; ++i)
-            {
-                fifoBuffer[(start2 + i) * 2 + channel] = channelData[size1 + i];
-            }
+            const float* channelData = buffer.getReadPointer(sourceChannel, startSample);
+            juce::FloatVectorOperations::copy(lane + region.start1, channelData, region.size1);
+            juce::FloatVectorOperations::copy(lane + region.start2, channelData + region.size1, region.size2);
         }
         
-        // Fill missing channel with zeros if mono input
-        if (numChannels == 1)
+        ring.fifo.finishedWrite(samplesToWrite);
+    }
+    
+    producerRing.store(&ring);
+    producerInUse.store(false);
+}
+
+int VirtualAudioDevice_Linux::getLatencySamples() const
+{
+    // Native mode has no FIFO hop, only the JACK period
+    if (isNativeMode())
+        return bufferSize.load();
+    
+    return queuedFrames.load() + bufferSize.load();
+}
+
+void VirtualAudioDevice_Linux::setFormatChangedCallback(std::function<void(int, int)> callback)
+{
+    const juce::ScopedLock sl(formatCallbackLock);
+    formatChangedCallback = std::move(callback);
+}
+
+void VirtualAudioDevice_Linux::setNativeCallback(juce::AudioIODeviceCallback* callback)
+{
+    nativeCallback.store(callback);
+    
+    // Wait out a process cycle that may still be running the previous callback.
+    // Both sides use sequentially consistent operations, so either the JACK
+    // thread sees the new pointer or we see it busy.
+    while (nativeCallbackInUse.load())
+        juce::Thread::sleep(1);
+    
+    DBG("Linux virtual audio device " + juce::String(callback != nullptr ? "entered" : "left") + " native mode");
+}
+
+bool VirtualAudioDevice_Linux::processNative(jack_nframes_t nframes)
+{
+    nativeCallbackInUse.store(true);
+    auto* callback = nativeCallback.load();
+    
+    if (callback != nullptr)
+    {
+        const float* inputChannels[] = { static_cast<const float*>(jack_port_get_buffer(inputPort, nframes)) };
+        
+        callback->audioDeviceIOCallbackWithContext(inputChannels, 1,
+                                                   outputChannels.data(), numChannels,
+                                                   static_cast<int>(nframes), {});
+    }
+    
+    nativeCallbackInUse.store(false);
+    return callback != nullptr;
+}
+
+int VirtualAudioDevice_Linux::getTargetFill(int period, int producerBlock) noexcept
+{
+    // Enough that the producer can arrive a block late without the JACK
+    // period running dry
+    return period + juce::jmax(period, producerBlock);
+}
+
+int VirtualAudioDevice_Linux::getRingCapacity(int period, int producerBlock) noexcept
+{
+    // Headroom on both sides of the target for jitter and for the
+    // compensator to pull the fill level back
+    return juce::nextPowerOfTwo(juce::jmax(minimumRingSize, 2 * getTargetFill(period, producerBlock)));
+}
+
+int VirtualAudioDevice_Linux::getFramesQueued() const noexcept
+{
+    // While a handover is pending the producer is already filling the new ring
+    auto* latest = writeRing.load();
+    const int queued = readRing->fifo.getNumReady();
+    return latest != readRing ? queued + latest->fifo.getNumReady() : queued;
+}
+
+int VirtualAudioDevice_Linux::readFromRing(float* const* destinations, int numFrames)
+{
+    int framesRead = 0;
+    
+    // After a reconfiguration the old ring is drained first, then the new one takes over
+    for (;;)
+    {
+        auto& fifo = readRing->fifo;
+        const auto region = fifo.prepareToRead(numFrames - framesRead);
+        
+        // Each channel has its own lane: one copy per wrap segment
+        for (int channel = 0; channel < numChannels; ++channel)
         {
-            for (int i = 0; i < size1; ++i)
-            {
-                fifoBuffer[(start1 + i) * 2 + 1] = 0.0f;
-            }
-            for (int i = 0; i < size2; ++i)
-            {
-                fifoBuffer[(start2 + i) * 2 + 1] = 0.0f;
-            }
+            float* destination = destinations[channel] + framesRead;
+            const float* lane = readRing->lanes.getReadPointer(channel);
+            
+            std::memcpy(destination, lane + region.start1, static_cast<size_t>(region.size1) * sizeof(float));
+            std::memcpy(destination + region.size1, lane + region.start2, static_cast<size_t>(region.size2) * sizeof(float));
+        }
+        
+        if (region.getTotalSize() > 0)
+            fifo.finishedRead(region.getTotalSize());
+        
+        framesRead += region.getTotalSize();
+        
+        if (framesRead == numFrames || !followWriteRing())
+            return framesRead;
+    }
+}
+
+int VirtualAudioDevice_Linux::readResampled(int numFrames)
+{
+    const int queued = getFramesQueued();
+    const int target = juce::jmin(getTargetFill(numFrames, producerBlockSize.load(std::memory_order_relaxed)),
+                                  writeRing.load()->fifo.getCapacity() / 2);
+    
+    // Stay silent until the ring holds its target fill, after startup and
+    // after every underrun
+    if (!isPrimed)
+    {
+        if (queued < target)
+            return 0;
+        
+        isPrimed = true;
+    }
+    
+    for (int framesWritten = 0; framesWritten < numFrames;)
+    {
+        const int chunk = juce::jmin(driftCompensator.getMaximumChunkSize(), numFrames - framesWritten);
+        const int framesNeeded = driftCompensator.getInputFramesNeeded(chunk);
+        
+        if (readFromRing(driftCompensator.getInputChannels(), framesNeeded) < framesNeeded)
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            driftCompensator.reset();
+            isPrimed = false;
+            queuedFrames.store(0);
+            return framesWritten;
         }
         
-        audioFifo.finishedWrite(samplesToWrite);
+        driftCompensator.process(outputChannels.data(), framesWritten, chunk);
+        framesWritten += chunk;
     }
+    
+    driftCompensator.updateRatio(queued, target, numFrames, static_cast<double>(sampleRate.load()));
+    clockDriftPpm.store(static_cast<float>((driftCompensator.getRatio() - 1.0) * 1.0e6));
+    queuedFrames.store(getFramesQueued());
+    
+    return numFrames;
+}
+
+bool VirtualAudioDevice_Linux::followWriteRing() noexcept
+{
+    auto* latest = writeRing.load();
+    
+    if (latest == readRing)
+        return false;
+    
+    // The producer may have loaded the old ring just before the swap and still
+    // be writing to it. It is done with it once it is idle (its next block
+    // loads the new ring) or has finished a block in the new ring.
+    if (producerInUse.load() && producerRing.load() != latest)
+        return false;
+    
+    // Whatever that last block left in the old ring is played first
+    if (readRing->fifo.getNumReady() > 0)
+        return true;
+    
+    // The reconfiguration thread waits for this ring to be reclaimed before
+    // publishing another, so the retired slot is always free here
+    retiredRing.store(readRing);
+    readRing = latest;
+    return true;
 }
 
 //==============================================================================
@@ -147,43 +333,46 @@ void VirtualAudioDevice_Linux::processAudioBlock(const juce::AudioBuffer<float>&
 int VirtualAudioDevice_Linux::jackProcessCallback(jack_nframes_t nframes, void* arg)
 {
     auto* device = static_cast<VirtualAudioDevice_Linux*>(arg);
+    const int numFrames = static_cast<int>(nframes);
+    const CallbackProfiler::ScopedCallback profile(device->profiler, numFrames);
     
-    if (!device->active.load())
-        return 0;
-    
-    // Get JACK port buffers
-    auto* inputBuffer = static_cast<jack_default_audio_sample_t*>(
-        jack_port_get_buffer(device->inputPort, nframes));
-    auto* outputBuffer = static_cast<jack_default_audio_sample_t*>(
-        jack_port_get_buffer(device->outputPort, nframes));
+    for (size_t channel = 0; channel < device->outputPorts.size(); ++channel)
+        device->outputChannels[channel] = static_cast<float*>(jack_port_get_buffer(device->outputPorts[channel], nframes));
     
-    // Clear output buffer
-    std::memset(outputBuffer, 0, nframes * sizeof(jack_default_audio_sample_t));
+    const bool isActive = device->active.load();
     
-    // Read audio data from FIFO
-    juce::ScopedLock lock(device->bufferLock);
+    // Native mode: input port -> engine -> output ports, no FIFO
+    if (isActive && device->processNative(nframes))
+    {
+        device->followWriteRing();
+        device->isPrimed = false;
+        return 0;
+    }
     
-    const int availableData = device->audioFifo.getNumReady();
-    const int samplesToRead = juce::jmin(static_cast<int>(nframes), availableData);
+    // Read audio data from FIFO (consumer side, wait-free); inactive ports just output silence
+    int framesRead = 0;
     
-    if (samplesToRead > 0)
+    if (isActive)
     {
-        int start1, size1, start2, size2;
-        device->audioFifo.prepareToRead(samplesToRead, start1, size1, start2, size2);
-        
-        // De-interleave audio data from FIFO buffer to JACK output
-        for (int i = 0; i < size1; ++i)
-        {
-            outputBuffer[i] = device->fifoBuffer[(start1 + i) * 2]; // Left channel
-        }
-        for (int i = 0; i < size2; ++i)
+        framesRead = device->readResampled(numFrames);
+    }
+    else
+    {
+        // Drop anything left over so that the next activation starts from an empty ring
+        do
         {
-            outputBuffer[size1 + i] = device->fifoBuffer[(start2 + i) * 2]; // Left channel
+            auto& fifo = device->readRing->fifo;
+            fifo.finishedRead(fifo.getNumReady());
         }
+        while (device->followWriteRing());
         
-        device->audioFifo.finishedRead(samplesToRead);
+        device->driftCompensator.reset();
+        device->isPrimed = false;
     }
     
+    for (auto* output : device->outputChannels)
+        std::memset(output + framesRead, 0, static_cast<size_t>(numFrames - framesRead) * sizeof(float));
+    
     return 0;
 }
 
@@ -198,7 +387,8 @@ void VirtualAudioDevice_Linux::jackShutdownCallback(void* arg)
 int VirtualAudioDevice_Linux::jackSampleRateCallback(jack_nframes_t nframes, void* arg)
 {
     auto* device = static_cast<VirtualAudioDevice_Linux*>(arg);
-    device->sampleRate = static_cast<int>(nframes);
+    device->requestedSampleRate.store(static_cast<int>(nframes));
+    device->notify();
     DBG("JACK sample rate changed to: " + juce::String(nframes));
     return 0;
 }
@@ -206,11 +396,81 @@ int VirtualAudioDevice_Linux::jackSampleRateCallback(jack_nframes_t nframes, voi
 int VirtualAudioDevice_Linux::jackBufferSizeCallback(jack_nframes_t nframes, void* arg)
 {
     auto* device = static_cast<VirtualAudioDevice_Linux*>(arg);
-    device->bufferSize = static_cast<int>(nframes);
+    device->requestedBufferSize.store(static_cast<int>(nframes));
+    device->notify();
     DBG("JACK buffer size changed to: " + juce::String(nframes));
     return 0;
 }
 
+//==============================================================================
+// Reconfiguration thread
+
+void VirtualAudioDevice_Linux::run()
+{
+    while (!threadShouldExit())
+    {
+        reclaimRetiredRing();
+        applyRequestedFormat();
+        
+        // Poll quickly only while a handover is in flight
+        wait(handoverFrom != nullptr ? 10 : 100);
+    }
+}
+
+void VirtualAudioDevice_Linux::applyRequestedFormat()
+{
+    const int newSampleRate = requestedSampleRate.load();
+    const int newBufferSize = requestedBufferSize.load();
+    const int newProducerBlockSize = producerBlockSize.load();
+    const bool formatChanged = newSampleRate != sampleRate.load() || newBufferSize != bufferSize.load();
+    
+    if (!formatChanged && newProducerBlockSize == ringProducerBlockSize)
+        return;
+    
+    // One handover at a time
+    if (handoverFrom != nullptr || writeRing.load() == nullptr)
+        return;
+    
+    const int wantedCapacity = getRingCapacity(newBufferSize, newProducerBlockSize);
+    auto* currentRing = writeRing.load();
+    ringProducerBlockSize = newProducerBlockSize;
+    
+    if (currentRing->fifo.getCapacity() != wantedCapacity)
+    {
+        // Built here, published with one store; the audio threads only ever swap pointers
+        auto* newRing = rings.add(new Ring(numChannels, wantedCapacity));
+        handoverFrom = currentRing;
+        writeRing.store(newRing);
+        DBG("JACK ring resized to " + juce::String(wantedCapacity) + " frames");
+    }
+    
+    if (!formatChanged)
+        return;
+    
+    sampleRate.store(newSampleRate);
+    bufferSize.store(newBufferSize);
+    profiler.prepare(newSampleRate);
+    DBG("JACK format applied: " + juce::String(newSampleRate) + " Hz, " + juce::String(newBufferSize) + " samples");
+    
+    const juce::ScopedLock sl(formatCallbackLock);
+    
+    if (formatChangedCallback)
+        formatChangedCallback(newSampleRate, newBufferSize);
+}
+
+void VirtualAudioDevice_Linux::reclaimRetiredRing()
+{
+    // The JACK thread only retires a ring once the producer is done with it
+    auto* retired = retiredRing.load();
+    
+    if (retired == nullptr)
+        return;
+    
+    retiredRing.store(nullptr);
+    handoverFrom = nullptr;
+    rings.removeObject(retired);
+}
+
 //==============================================================================
 // Helper Methods
 
@@ -248,15 +508,22 @@ bool VirtualAudioDevice_Linux::createJackPorts()
         return false;
     }
     
-    // Create output port (for sending processed audio to other applications)
-    outputPort = jack_port_register(jackClient, "output", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
-    if (!outputPort)
+    // Create output ports (for sending processed audio to other applications)
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        DBG("Failed to create JACK output port");
-        return false;
+        const juce::String portName = "output_" + juce::String(channel + 1);
+        auto* port = jack_port_register(jackClient, portName.toUTF8(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        
+        if (!port)
+        {
+            DBG("Failed to create JACK output port " + portName);
+            return false;
+        }
+        
+        outputPorts.push_back(port);
     }
     
-    DBG("JACK ports created successfully");
+    DBG("JACK ports created successfully (" + juce::String(numChannels) + " outputs)");
     return true;
 }
 
@@ -1,26 +1,81 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SpscFifo.h"
+#include "DriftCompensator.h"
+#include "CallbackProfiler.h"
 #include <jack/jack.h>
-#include <memory>
+#include <vector>
 #include <atomic>
+#include <functional>
 
 //==============================================================================
-class VirtualAudioDevice_Linux
+// JACK client exposing the processed signal as numOutputChannels output
+// ports ("output_1" ... "output_N"). The audio device thread writes into a
+// planar ring (one contiguous lane per port) and the JACK thread copies each
+// lane straight into its port buffer, one memcpy per wrap segment.
+//
+// The two sides run on different clocks (the JUCE device's and the JACK
+// server's), so the JACK thread reads through a DriftCompensator that holds
+// the ring at a target fill of one producer block plus one period. That fill
+// is the FIFO's whole added latency, and the ring only needs headroom around
+// it rather than enough slack to absorb drift for a whole session.
+//
+// In native mode the FIFO is bypassed: the JACK thread hands the "input"
+// port and the output ports directly to an AudioIODeviceCallback (the
+// engine), so the only added latency is the JACK period itself.
+//
+// JACK period and sample rate changes are applied RCU-style by a private
+// reconfiguration thread: it builds a ring sized for the new period and
+// publishes it with one atomic store. The producer moves over with its next
+// block; the JACK thread follows once the producer can no longer write to
+// the old ring and that ring has been drained, and the old ring is then freed.
+// Nothing is allocated or freed on either audio thread.
+class VirtualAudioDevice_Linux : private juce::Thread
 {
 public:
-    VirtualAudioDevice_Linux();
-    ~VirtualAudioDevice_Linux();
+    explicit VirtualAudioDevice_Linux(int numOutputChannels = 2);
+    ~VirtualAudioDevice_Linux() override;
     
     bool initialize(const juce::String& deviceName);
     void shutdown();
     
     bool isAvailable() const { return jackClient != nullptr; }
     bool isActive() const { return active.load(); }
+    int getNumChannels() const { return numChannels; }
     
     void setActive(bool shouldBeActive);
     void processAudioBlock(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
     
+    // FIFO health (lock-free, safe to poll from the UI)
+    uint32_t getOverrunCount() const { return overruns.load(); }
+    uint32_t getUnderrunCount() const { return underruns.load(); }
+    
+    // Current resampling correction against the JUCE device's clock, in ppm
+    float getClockDriftPpm() const { return clockDriftPpm.load(); }
+    
+    // Timing of the JACK process callback against the JACK period
+    CallbackProfiler& getProfiler() { return profiler; }
+    
+    // Frames between processAudioBlock() and the port outputs: what is queued
+    // in the FIFO plus one JACK period (approximate when polled from the UI).
+    // Just the JACK period in native mode.
+    int getLatencySamples() const;
+    
+    // Native mode: run the callback inside the JACK process callback (nullptr
+    // returns to FIFO mode). Prepare the callback for getSampleRate() and
+    // getBufferSize() first; once this returns, the JACK thread has stopped
+    // using the previous callback.
+    void setNativeCallback(juce::AudioIODeviceCallback* callback);
+    bool isNativeMode() const { return nativeCallback.load() != nullptr; }
+    
+    int getSampleRate() const { return sampleRate.load(); }
+    int getBufferSize() const { return bufferSize.load(); }
+    
+    // Called on the reconfiguration thread once a new JACK sample rate or
+    // period is in effect; re-prepare a native mode callback from here
+    void setFormatChangedCallback(std::function<void(int sampleRate, int bufferSize)> callback);
+    
     // JACK callbacks
     static int jackProcessCallback(jack_nframes_t nframes, void* arg);
     static void jackShutdownCallback(void* arg);
@@ -31,23 +86,74 @@ private:
     // JACK client and ports
     jack_client_t* jackClient = nullptr;
     jack_port_t* inputPort = nullptr;
-    jack_port_t* outputPort = nullptr;
+    std::vector<jack_port_t*> outputPorts;
+    std::vector<float*> outputChannels;     // port buffers for the native callback
+    
+    // Wait-free FIFO between the audio device thread and the JACK thread,
+    // with its planar storage (one lane per output port)
+    struct Ring
+    {
+        Ring(int numLanes, int minimumCapacity);
+        
+        SpscFifo fifo;
+        juce::AudioBuffer<float> lanes;
+    };
     
-    // Audio buffer for inter-thread communication
-    juce::AudioBuffer<float> audioBuffer;
-    juce::AbstractFifo audioFifo;
-    std::unique_ptr<float[]> fifoBuffer;
+    static constexpr int minimumRingSize = 256;     // frames
+    static constexpr int driftChunkSize = 256;      // resampler output chunk, frames
+    const int numChannels;
+    
+    static int getTargetFill(int period, int producerBlock) noexcept;
+    static int getRingCapacity(int period, int producerBlock) noexcept;
+    
+    juce::OwnedArray<Ring> rings;                   // reconfiguration thread only
+    std::atomic<Ring*> writeRing { nullptr };       // producer side
+    Ring* readRing = nullptr;                       // JACK thread; trails writeRing until drained
+    std::atomic<Ring*> retiredRing { nullptr };     // let go by the JACK thread, awaiting reclaim
+    Ring* handoverFrom = nullptr;                   // reconfiguration thread: ring being replaced
+    std::atomic<bool> producerInUse { false };
+    std::atomic<Ring*> producerRing { nullptr };    // ring the producer last finished a block in
+    std::atomic<int> queuedFrames { 0 };
+    std::atomic<uint32_t> overruns { 0 };
+    std::atomic<uint32_t> underruns { 0 };
+    
+    // Drift compensation (JACK thread), fed with the largest producer block seen
+    DriftCompensator driftCompensator;
+    bool isPrimed = false;                          // ring has reached its target fill
+    std::atomic<int> producerBlockSize { 0 };
+    int ringProducerBlockSize = 0;                  // reconfiguration thread: what the ring is sized for
+    std::atomic<float> clockDriftPpm { 0.0f };
+    
+    CallbackProfiler profiler;
+    
+    // Native mode
+    std::atomic<juce::AudioIODeviceCallback*> nativeCallback { nullptr };
+    std::atomic<bool> nativeCallbackInUse { false };
     
     // State
     std::atomic<bool> active{false};
     std::atomic<bool> initialized{false};
     
-    // Audio parameters
-    int sampleRate = 44100;
-    int bufferSize = 512;
+    // Audio parameters: in effect, and as last reported by JACK
+    std::atomic<int> sampleRate { 44100 };
+    std::atomic<int> bufferSize { 512 };
+    std::atomic<int> requestedSampleRate { 44100 };
+    std::atomic<int> requestedBufferSize { 512 };
+    
+    juce::CriticalSection formatCallbackLock;
+    std::function<void(int, int)> formatChangedCallback;
     
-    // Thread safety
-    juce::CriticalSection bufferLock;
+    // Reconfiguration thread
+    void run() override;
+    void applyRequestedFormat();
+    void reclaimRetiredRing();
+    
+    // JACK thread
+    bool processNative(jack_nframes_t nframes);
+    int readFromRing(float* const* destinations, int numFrames);
+    int readResampled(int numFrames);
+    int getFramesQueued() const noexcept;
+    bool followWriteRing() noexcept;
     
     // Helper methods
     bool createJackClient(const juce::String& clientName);
@@ -55,6 +161,9 @@ private:
     bool activateJackClient();
     void deactivateJackClient();
     
+    // Drives the ring handover directly, without a JACK server (test_application.cpp)
+    friend class RingHandoverTests;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioDevice_Linux)
 };
 
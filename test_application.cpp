@@ -1,74 +1,824 @@
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include "PresetSettings.h"
+#include "GainComputer.h"
+#include "GainRamp.h"
 #include <iostream>
-#include <memory>
-
-// Mock JUCE headers for testing
-namespace juce {
-    class String {
-    public:
-        String(const char* text) : text_(text) {}
-        const char* toUTF8() const { return text_.c_str(); }
-    private:
-        std::string text_;
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if JUCE_LINUX
+ #include "VirtualAudioDevice_Linux.h"
+ #include <thread>
+#endif
+
+//==============================================================================
+// Regression tests for the DSP path, run by CTest (see CMakeLists.txt).
+//
+// The "Golden" category renders fixed, generated input signals through every
+// shipped preset with OfflineRenderer, exactly as AudioProcessorCLI would,
+// and compares the output with reference files in TestData/golden. The
+// "Consistency" category needs no references: a reused renderer must repeat
+// itself bit for bit, and the SIMD kernels must agree with the scalar paths.
+// On Linux the "Handover" category stress-tests the JACK device's ring swap.
+//
+// After an intended change in the sound, run with --update-golden, listen to
+// the new references and commit them together with the change.
+namespace
+{
+    constexpr int skipReturnCode = 77;      // SKIP_RETURN_CODE in CMakeLists.txt
+
+    const char* const presetNames[] = { "Default", "Podcast", "Streaming", "VoiceOver", "SlammedUp" };
+
+    // Covers kernel choice (SSE2/AVX2/NEON differ below 0.001 dB) and compiler
+    // floating-point differences; a real change in the sound is far above this
+    constexpr float maxPeakError = 1.0e-3f;     // -60 dBFS
+    constexpr float maxRmsError = 1.0e-4f;      // -80 dBFS
+
+    // Every preset must leave the test signals audible, or a silent render
+    // could become its own reference and pass from then on
+    constexpr float minOutputPeak = 1.0e-3f;    // -60 dBFS
+
+    constexpr double maxKernelErrorDb = 0.001;
+
+    struct Options
+    {
+        juce::File sourceDirectory;
+        bool updateGolden = false;
     };
-    
-    class AudioBuffer {
-    public:
-        AudioBuffer(int channels, int samples) : channels_(channels), samples_(samples) {}
-        int getNumChannels() const { return channels_; }
-        int getNumSamples() const { return samples_; }
-        float getMagnitude(int start, int length) const { return 0.5f; }
-    private:
-        int channels_, samples_;
+
+    Options options;
+    int numMissingReferences = 0;
+
+    //==============================================================================
+    enum class Signal
+    {
+        speech,         // syllables over a -60 dBFS noise floor: gate and compressor
+        sweep,          // 40 Hz - 16 kHz while rising from -40 to 0 dBFS: every threshold
+        transients      // -6 to 0 dBFS noise hits with fast decays: limiter lookahead
     };
-    
-    namespace Decibels {
-        static float gainToDecibels(float gain) { return 20.0f * std::log10(gain); }
-        static float decibelsToGain(float db) { return std::pow(10.0f, db / 20.0f); }
+
+    const Signal signals[] = { Signal::speech, Signal::sweep, Signal::transients };
+
+    const char* getSignalName(Signal signal)
+    {
+        switch (signal)
+        {
+            case Signal::speech:        return "speech";
+            case Signal::sweep:         return "sweep";
+            case Signal::transients:    return "transients";
+            default:                    break;
+        }
+
+        return "unknown";
+    }
+
+    constexpr double testSampleRate = 48000.0;
+    constexpr int testNumChannels = 2;
+    constexpr double testSeconds = 3.0;
+
+    // Seeded, so every platform renders the same input
+    juce::AudioBuffer<float> createSignal(Signal signal)
+    {
+        const auto numSamples = static_cast<int>(testSampleRate * testSeconds);
+        juce::AudioBuffer<float> buffer(testNumChannels, numSamples);
+        buffer.clear();
+
+        for (int channel = 0; channel < testNumChannels; ++channel)
+        {
+            float* data = buffer.getWritePointer(channel);
+            juce::Random random(4321 + channel);
+
+            if (signal == Signal::speech)
+            {
+                int i = 0;
+                double voicePhase = 0.0;
+
+                while (i < numSamples)
+                {
+                    const int length = static_cast<int>(testSampleRate * (0.08 + 0.22 * random.nextDouble()));
+                    const int gap = static_cast<int>(testSampleRate * (0.04 + 0.2 * random.nextDouble()));
+                    const float level = 0.05f + 0.6f * random.nextFloat();
+                    const double pitch = 110.0 + 60.0 * random.nextDouble();
+
+                    for (int n = 0; n < length && i < numSamples; ++n, ++i)
+                    {
+                        const double envelope = std::sin(juce::MathConstants<double>::pi * n / length);
+                        voicePhase += juce::MathConstants<double>::twoPi * pitch / testSampleRate;
+
+                        const double voiced = 0.6 * std::sin(voicePhase) + 0.25 * std::sin(2.0 * voicePhase)
+                                            + 0.15 * std::sin(3.0 * voicePhase);
+                        const double breath = 0.1 * (2.0 * random.nextDouble() - 1.0);
+
+                        data[i] = static_cast<float>(level * envelope * (voiced + breath));
+                    }
+
+                    for (int n = 0; n < gap && i < numSamples; ++n, ++i)
+                        data[i] = 0.001f * (2.0f * random.nextFloat() - 1.0f);
+                }
+            }
+            else if (signal == Signal::sweep)
+            {
+                const double startHz = 40.0, endHz = 16000.0;
+                const double rate = std::log(endHz / startHz) / numSamples;
+                const double phaseOffset = channel * 0.25;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const double phase = juce::MathConstants<double>::twoPi * startHz * (std::exp(rate * i) - 1.0) / (rate * testSampleRate);
+                    const double levelDb = -40.0 + 40.0 * i / numSamples;
+
+                    data[i] = static_cast<float>(juce::Decibels::decibelsToGain(levelDb) * std::sin(phase + phaseOffset));
+                }
+            }
+            else
+            {
+                // A hit every 100-400 ms, decaying with a 5-60 ms time constant
+                int i = static_cast<int>(testSampleRate * 0.05);
+
+                while (i < numSamples)
+                {
+                    const double decay = std::exp(-1.0 / (testSampleRate * (0.005 + 0.055 * random.nextDouble())));
+                    const int spacing = static_cast<int>(testSampleRate * (0.1 + 0.3 * random.nextDouble()));
+                    double envelope = 0.5 + 0.5 * random.nextDouble();
+
+                    for (int n = 0; n < spacing && i < numSamples; ++n, ++i)
+                    {
+                        data[i] = static_cast<float>(envelope * (2.0 * random.nextDouble() - 1.0));
+                        envelope *= decay;
+                    }
+                }
+            }
+        }
+
+        return buffer;
+    }
+
+    //==============================================================================
+    // 32-bit WAV is float in JUCE, so renders and references round-trip exactly
+    juce::Result writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        if (!file.deleteFile())
+            return juce::Result::fail("Cannot overwrite " + file.getFullPathName());
+
+        std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+            return juce::Result::fail("Cannot create " + file.getFullPathName());
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate,
+                                                                                  static_cast<unsigned int>(buffer.getNumChannels()),
+                                                                                  32, {}, 0));
+        if (writer == nullptr)
+            return juce::Result::fail("Cannot write WAV: " + file.getFullPathName());
+
+        stream.release(); // now owned by the writer
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples()))
+            return juce::Result::fail("Write failed: " + file.getFullPathName());
+
+        return juce::Result::ok();
+    }
+
+    juce::Result readAudio(juce::AudioFormatManager& formatManager, const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+            return juce::Result::fail("Cannot read " + file.getFullPathName());
+
+        buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        return juce::Result::ok();
+    }
+
+    bool isBitIdentical(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            if (std::memcmp(a.getReadPointer(channel), b.getReadPointer(channel),
+                            sizeof(float) * static_cast<size_t>(a.getNumSamples())) != 0)
+                return false;
+
+        return true;
+    }
+
+    juce::File getScratchDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("AudioProcessorTests");
+    }
+
+    juce::File getPresetFile(const juce::String& presetName)
+    {
+        return options.sourceDirectory.getChildFile(presetName + ".preset");
+    }
+
+    juce::File getGoldenDirectory()
+    {
+        return options.sourceDirectory.getChildFile("TestData").getChildFile("golden");
     }
 }
 
-// Include our audio processing classes
-#include "../AudioProcessor/Source/Compressor.h"
-#include "../AudioProcessor/Source/Limiter.h"
+//==============================================================================
+class GoldenOutputTests : public juce::UnitTest
+{
+public:
+    GoldenOutputTests() : juce::UnitTest("Golden output", "Golden") {}
+
+    void runTest() override
+    {
+        const auto scratch = getScratchDirectory();
+        const auto goldenDirectory = getGoldenDirectory();
+
+        beginTest("Setup");
+        expect(scratch.createDirectory().wasOk(), "Cannot create " + scratch.getFullPathName());
+
+        if (options.updateGolden)
+            expect(goldenDirectory.createDirectory().wasOk(), "Cannot create " + goldenDirectory.getFullPathName());
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        for (const auto signal : signals)
+        {
+            const auto inputFile = scratch.getChildFile(juce::String("input_") + getSignalName(signal) + ".wav");
+            const auto result = writeWav(inputFile, createSignal(signal), testSampleRate);
+            expect(result.wasOk(), result.getErrorMessage());
+
+            for (const auto* presetName : presetNames)
+            {
+                const auto caseName = juce::String(presetName) + "_" + getSignalName(signal);
+                beginTest(caseName);
+
+                PresetSettings settings;
+                if (!settings.loadFromFile(getPresetFile(presetName)))
+                {
+                    expect(false, "Cannot load " + getPresetFile(presetName).getFullPathName());
+                    continue;
+                }
+
+                OfflineRenderer renderer;
+                renderer.setSettings(settings);
+
+                const auto outputFile = scratch.getChildFile(caseName + ".wav");
+                OfflineRenderer::Stats stats;
+                const auto renderResult = renderer.renderFile(inputFile, outputFile, stats);
+
+                if (!renderResult.wasOk())
+                {
+                    expect(false, renderResult.getErrorMessage());
+                    continue;
+                }
+
+                if (!expectNotSilent(formatManager, outputFile))
+                    continue;
+
+                const auto referenceFile = goldenDirectory.getChildFile(caseName + ".wav");
+
+                if (options.updateGolden)
+                {
+                    expect(outputFile.copyFileTo(referenceFile), "Cannot write " + referenceFile.getFullPathName());
+                    logMessage("Updated " + referenceFile.getFullPathName());
+                    continue;
+                }
+
+                if (!referenceFile.existsAsFile())
+                {
+                    ++numMissingReferences;
+                    logMessage("No reference " + referenceFile.getFullPathName() + ", skipped");
+                    continue;
+                }
+
+                compareWithReference(formatManager, outputFile, referenceFile);
+            }
+        }
+    }
+
+private:
+    bool expectNotSilent(juce::AudioFormatManager& formatManager, const juce::File& outputFile)
+    {
+        juce::AudioBuffer<float> output;
+        const auto result = readAudio(formatManager, outputFile, output);
+
+        if (!result.wasOk())
+        {
+            expect(false, result.getErrorMessage());
+            return false;
+        }
+
+        const auto peak = output.getMagnitude(0, output.getNumSamples());
+        expectGreaterThan(peak, minOutputPeak,
+                          "Output peak " + juce::String(juce::Decibels::gainToDecibels(peak), 1) + " dBFS, the render is silent");
+        return peak > minOutputPeak;
+    }
+
+    void compareWithReference(juce::AudioFormatManager& formatManager, const juce::File& outputFile,
+                              const juce::File& referenceFile)
+    {
+        juce::AudioBuffer<float> output, reference;
+
+        auto result = readAudio(formatManager, outputFile, output);
+        if (result.wasOk())
+            result = readAudio(formatManager, referenceFile, reference);
+
+        if (!result.wasOk())
+        {
+            expect(false, result.getErrorMessage());
+            return;
+        }
 
-int main()
+        expectEquals(output.getNumChannels(), reference.getNumChannels(), "Channel count");
+        expectEquals(output.getNumSamples(), reference.getNumSamples(), "Length");
+
+        if (output.getNumChannels() != reference.getNumChannels() || output.getNumSamples() != reference.getNumSamples())
+            return;
+
+        float peakError = 0.0f;
+        double sumSquaredError = 0.0;
+        int peakErrorSample = 0;
+
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            const float* rendered = output.getReadPointer(channel);
+            const float* expected = reference.getReadPointer(channel);
+
+            for (int i = 0; i < output.getNumSamples(); ++i)
+            {
+                const float error = std::abs(rendered[i] - expected[i]);
+                sumSquaredError += static_cast<double>(error) * error;
+
+                if (error > peakError)
+                {
+                    peakError = error;
+                    peakErrorSample = i;
+                }
+            }
+        }
+
+        const auto rmsError = static_cast<float>(std::sqrt(sumSquaredError / (output.getNumChannels() * output.getNumSamples())));
+
+        expectLessOrEqual(peakError, maxPeakError,
+                          "Peak error " + juce::String(peakError, 6) + " at sample " + juce::String(peakErrorSample));
+        expectLessOrEqual(rmsError, maxRmsError, "RMS error " + juce::String(rmsError, 7));
+    }
+};
+
+static GoldenOutputTests goldenOutputTests;
+
+//==============================================================================
+class RenderDeterminismTests : public juce::UnitTest
 {
-    std::cout << "Audio Processing Application Test\n";
-    std::cout << "================================\n\n";
-    
-    // Test Compressor
-    std::cout << "Testing Compressor...\n";
-    Compressor compressor;
-    compressor.prepareToPlay(44100.0, 512);
-    compressor.setThreshold(-20.0f);
-    compressor.setRatio(4.0f);
-    compressor.setAttack(1.0f);
-    compressor.setRelease(30.0f);
-    std::cout << "✓ Compressor initialized successfully\n";
-    
-    // Test Limiter
-    std::cout << "Testing Limiter...\n";
-    Limiter limiter;
-    limiter.prepareToPlay(44100.0, 512);
-    limiter.setCeiling(-0.3f);
-    limiter.setLookahead(3.0f);
-    limiter.setRelease(300.0f);
-    std::cout << "✓ Limiter initialized successfully\n";
-    
-    // Test audio processing chain
-    std::cout << "Testing audio processing chain...\n";
-    juce::AudioBuffer<float> testBuffer(2, 512);
-    
-    // Simulate audio processing
-    float testGainReduction = compressor.processBlock(testBuffer);
-    float testLimitingGR = limiter.processBlock(testBuffer);
-    
-    std::cout << "✓ Audio processing chain working\n";
-    std::cout << "  - Compressor gain reduction: " << testGainReduction << " dB\n";
-    std::cout << "  - Limiter gain reduction: " << testLimitingGR << " dB\n";
-    
-    std::cout << "\n✅ All tests passed! Application is ready.\n";
-    
-    return 0;
+public:
+    RenderDeterminismTests() : juce::UnitTest("Render determinism", "Consistency") {}
+
+    void runTest() override
+    {
+        const auto scratch = getScratchDirectory();
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        beginTest("Setup");
+        expect(scratch.createDirectory().wasOk(), "Cannot create " + scratch.getFullPathName());
+
+        const auto inputFile = scratch.getChildFile("determinism_input.wav");
+        const auto result = writeWav(inputFile, createSignal(Signal::speech), testSampleRate);
+        expect(result.wasOk(), result.getErrorMessage());
+
+        // BatchRenderer reuses one renderer per worker, so every file has to
+        // come out as if it were the first
+        for (const auto* presetName : presetNames)
+        {
+            beginTest(juce::String(presetName) + " renders identically when reused");
+
+            PresetSettings settings;
+            if (!settings.loadFromFile(getPresetFile(presetName)))
+            {
+                expect(false, "Cannot load " + getPresetFile(presetName).getFullPathName());
+                continue;
+            }
+
+            OfflineRenderer reused, fresh;
+            reused.setSettings(settings);
+            fresh.setSettings(settings);
+
+            juce::AudioBuffer<float> renders[3];
+            OfflineRenderer* renderers[] = { &reused, &reused, &fresh };
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const auto outputFile = scratch.getChildFile("determinism_" + juce::String(i) + ".wav");
+                OfflineRenderer::Stats stats;
+                auto renderResult = renderers[i]->renderFile(inputFile, outputFile, stats);
+
+                if (renderResult.wasOk())
+                    renderResult = readAudio(formatManager, outputFile, renders[i]);
+
+                expect(renderResult.wasOk(), renderResult.getErrorMessage());
+            }
+
+            expect(isBitIdentical(renders[0], renders[1]), "Second render with the same renderer differs");
+            expect(isBitIdentical(renders[0], renders[2]), "Render with a new renderer differs");
+        }
+    }
+};
+
+static RenderDeterminismTests renderDeterminismTests;
+
+//==============================================================================
+class GainComputerKernelTests : public juce::UnitTest
+{
+public:
+    GainComputerKernelTests() : juce::UnitTest("GainComputer kernels", "Consistency") {}
+
+    void runTest() override
+    {
+        // Odd length, so every kernel also runs its scalar tail
+        constexpr int numSamples = 4099;
+
+        // Log-uniform envelopes from -140 to +12 dBFS, plus exact zeros
+        juce::Random random(2024);
+        juce::HeapBlock<float> envelope(numSamples), decibels(numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            envelope[i] = i % 97 == 0 ? 0.0f : juce::Decibels::decibelsToGain(-140.0f + 152.0f * random.nextFloat(), -200.0f);
+            decibels[i] = -120.0f + 144.0f * random.nextFloat();
+        }
+
+        const float thresholds[] = { -80.0f, -40.0f, -12.0f, 0.0f };
+        const float ratios[] = { 1.5f, 4.0f, 20.0f, 50.0f };
+
+        GainComputer reference;
+        reference.setKernel(GainComputer::Kernel::scalarReference);
+
+        const GainComputer::Kernel kernels[] = { GainComputer::Kernel::sse2, GainComputer::Kernel::avx2, GainComputer::Kernel::neon };
+
+        for (const auto kernel : kernels)
+        {
+            if (!GainComputer::isKernelAvailable(kernel))
+            {
+                logMessage(GainComputer::getKernelName(kernel) + " is not available on this CPU, skipped");
+                continue;
+            }
+
+            beginTest(GainComputer::getKernelName(kernel) + " agrees with the scalar reference");
+
+            GainComputer simd;
+            simd.setKernel(kernel);
+            expect(simd.getKernel() == kernel);
+
+            juce::HeapBlock<float> expected(numSamples), actual(numSamples);
+
+            for (const float threshold : thresholds)
+            {
+                for (const float ratio : ratios)
+                {
+                    const auto thresholdGain = juce::Decibels::decibelsToGain(threshold);
+                    const auto context = " (threshold " + juce::String(threshold) + " dB, ratio " + juce::String(ratio) + ")";
+
+                    reference.computeExpanderGains(envelope, expected, numSamples, thresholdGain, ratio);
+                    simd.computeExpanderGains(envelope, actual, numSamples, thresholdGain, ratio);
+                    expectGainsAgree(expected, actual, numSamples, "Expander" + context);
+
+                    reference.computeCompressorGains(envelope, expected, numSamples, thresholdGain, ratio);
+                    simd.computeCompressorGains(envelope, actual, numSamples, thresholdGain, ratio);
+                    expectGainsAgree(expected, actual, numSamples, "Compressor" + context);
+                }
+            }
+
+            reference.decibelsToGains(decibels, expected, numSamples);
+            simd.decibelsToGains(decibels, actual, numSamples);
+            expectGainsAgree(expected, actual, numSamples, "decibelsToGains");
+        }
+    }
+
+private:
+    // Within maxKernelErrorDb, or both at or below -100 dB, where the scalar
+    // path floors the gain to zero and the SIMD kernels do not
+    void expectGainsAgree(const float* expected, const float* actual, int numSamples, const juce::String& what)
+    {
+        const float silentGain = juce::Decibels::decibelsToGain(-100.0f, -200.0f);
+        double worstErrorDb = 0.0;
+        int worstSample = -1;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (expected[i] == actual[i] || (expected[i] <= silentGain && actual[i] <= silentGain))
+                continue;
+
+            const double errorDb = expected[i] > 0.0f && actual[i] > 0.0f
+                                       ? std::abs(20.0 * std::log10(static_cast<double>(actual[i]) / expected[i]))
+                                       : std::numeric_limits<double>::infinity();
+
+            if (errorDb > worstErrorDb)
+            {
+                worstErrorDb = errorDb;
+                worstSample = i;
+            }
+        }
+
+        expect(worstErrorDb <= maxKernelErrorDb,
+               what + ": " + juce::String(worstErrorDb, 5) + " dB off at sample " + juce::String(worstSample));
+    }
+};
+
+static GainComputerKernelTests gainComputerKernelTests;
+
+//==============================================================================
+class GainRampTests : public juce::UnitTest
+{
+public:
+    GainRampTests() : juce::UnitTest("GainRamp", "Consistency") {}
+
+    void runTest() override
+    {
+        beginTest("Linear ramp follows start + step * n");
+        checkRamp(GainRamp::Shape::linear, 0.25f, 2.0f);
+        checkRamp(GainRamp::Shape::linear, 1.0f, 0.0f);
+
+        beginTest("Exponential ramp follows start * ratio^n");
+        checkRamp(GainRamp::Shape::exponential, 0.25f, 2.0f);
+        checkRamp(GainRamp::Shape::exponential, 1.0f, 0.001f);
+
+        beginTest("Exponential ramp through zero falls back to linear");
+        checkRamp(GainRamp::Shape::exponential, 0.5f, 0.0f);
+
+        beginTest("applyGain matches fillRamp");
+        {
+            constexpr int blockSize = 300;
+            GainRamp forBlock, forValues;
+            forBlock.prepare(testSampleRate, blockSize, 0.01);
+            forValues.prepare(testSampleRate, blockSize, 0.01);
+            forBlock.setTargetValue(0.125f);
+            forValues.setTargetValue(0.125f);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::HeapBlock<float> values(blockSize);
+
+            for (int block = 0; block < 3; ++block)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    juce::FloatVectorOperations::fill(buffer.getWritePointer(channel), 1.0f, blockSize);
+
+                juce::dsp::AudioBlock<float> audioBlock(buffer);
+                forBlock.applyGain(audioBlock);
+                forValues.fillRamp(values, blockSize);
+
+                for (int channel = 0; channel < 2; ++channel)
+                    expect(std::memcmp(buffer.getReadPointer(channel), values.get(), sizeof(float) * blockSize) == 0,
+                           "Block " + juce::String(block) + ", channel " + juce::String(channel));
+            }
+        }
+    }
+
+private:
+    // Fills the whole ramp in chunks of odd sizes, so that both the SIMD body
+    // and the scalar tail run and chunks restart mid-ramp, and compares it with
+    // the closed form evaluated in double precision
+    void checkRamp(GainRamp::Shape shape, float start, float target)
+    {
+        constexpr double rampSeconds = 0.01;
+        const int rampLength = juce::roundToInt(testSampleRate * rampSeconds);
+        const int chunkSizes[] = { 1, 3, 4, 7, 64, 129 };
+
+        GainRamp ramp(shape, start);
+        ramp.prepare(testSampleRate, 512, rampSeconds);
+        ramp.setTargetValue(target);
+
+        const bool isGeometric = shape == GainRamp::Shape::exponential && start > 0.0f && target > 0.0f;
+        std::vector<float> values(static_cast<size_t>(rampLength + 16));
+        int position = 0;
+
+        for (int chunk = 0; position < static_cast<int>(values.size()); ++chunk)
+        {
+            const int size = juce::jmin(chunkSizes[chunk % juce::numElementsInArray(chunkSizes)],
+                                        static_cast<int>(values.size()) - position);
+            ramp.fillRamp(values.data() + position, size);
+            position += size;
+        }
+
+        double worstRelativeError = 0.0;
+
+        for (int n = 0; n < rampLength; ++n)
+        {
+            const double progress = (n + 1.0) / rampLength;
+            const double exact = isGeometric ? start * std::pow(static_cast<double>(target) / start, progress)
+                                             : start + (static_cast<double>(target) - start) * progress;
+            const double scale = juce::jmax(std::abs(exact), static_cast<double>(std::abs(target - start)) * 1.0e-3);
+
+            worstRelativeError = juce::jmax(worstRelativeError, std::abs(values[static_cast<size_t>(n)] - exact) / scale);
+        }
+
+        const auto context = juce::String(start) + " -> " + juce::String(target);
+
+        expect(worstRelativeError <= 1.0e-4, context + ": relative error " + juce::String(worstRelativeError, 7));
+        expectEquals(values[static_cast<size_t>(rampLength - 1)], target, context + ": does not land on the target");
+        expect(!ramp.isSmoothing(), context + ": still smoothing");
+
+        for (size_t n = static_cast<size_t>(rampLength); n < values.size(); ++n)
+            expectEquals(values[n], target, context + ": moves after landing");
+    }
+};
+
+static GainRampTests gainRampTests;
+
+#if JUCE_LINUX
+//==============================================================================
+// Runs the three sides of a JACK ring handover against each other: a
+// producer writing a counter signal, a reader standing in for the JACK
+// callback, and the reconfiguration thread swapping rings as fast as it can.
+// Every frame has to come out exactly once and in order.
+class RingHandoverTests : public juce::UnitTest
+{
+public:
+    RingHandoverTests() : juce::UnitTest("JACK ring handover", "Handover") {}
+
+    void runTest() override
+    {
+        beginTest("No frame is lost while rings are swapped");
+
+        // Many wide blocks keep the producer inside processAudioBlock() most
+        // of the time, which is where a swap can catch it
+        constexpr int numChannels = 32;
+        constexpr int producerBlock = 512;
+        constexpr int readerBlock = 96;
+        constexpr int numFrames = 1 << 22;          // the counter stays exact in a float
+        constexpr int periods[] = { 64, 2048 };     // rings of 2048 and 8192 frames
+        constexpr double timeoutMs = 60000.0;
+
+        using Device = VirtualAudioDevice_Linux;
+        Device device(numChannels);
+        const int smallestRing = Device::getRingCapacity(periods[0], producerBlock);
+
+        auto* firstRing = device.rings.add(new Device::Ring(numChannels, smallestRing));
+        device.readRing = firstRing;
+        device.writeRing.store(firstRing);
+        device.bufferSize.store(periods[0]);
+        device.requestedBufferSize.store(periods[0]);
+        device.producerBlockSize.store(producerBlock);
+        device.ringProducerBlockSize = producerBlock;
+        device.initialized.store(true);
+        device.active.store(true);
+
+        std::atomic<int> framesRead { 0 };
+        std::atomic<bool> stop { false };
+        int firstWrongFrame = -1;
+
+        std::thread producer([&]
+        {
+            juce::AudioBuffer<float> block(numChannels, producerBlock);
+
+            for (int frame = 0; frame < numFrames && !stop.load();)
+            {
+                // Never more than the smallest ring holds, so nothing is dropped as an overrun
+                if (frame - framesRead.load() > smallestRing - producerBlock)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int i = 0; i < producerBlock; ++i)
+                        block.setSample(channel, i, static_cast<float>(frame + i));
+
+                device.processAudioBlock(block, 0, producerBlock);
+                frame += producerBlock;
+            }
+        });
+
+        std::thread reader([&]
+        {
+            juce::AudioBuffer<float> block(numChannels, readerBlock);
+
+            for (int expected = 0; expected < numFrames && !stop.load();)
+            {
+                const int numRead = device.readFromRing(block.getArrayOfWritePointers(), readerBlock);
+
+                for (int i = 0; i < numRead; ++i, ++expected)
+                {
+                    if (block.getSample(0, i) != static_cast<float>(expected)
+                        || block.getSample(numChannels - 1, i) != static_cast<float>(expected))
+                    {
+                        firstWrongFrame = expected;
+                        stop.store(true);
+                        return;
+                    }
+                }
+
+                framesRead.store(expected);
+
+                if (numRead == 0)
+                    std::this_thread::yield();
+            }
+        });
+
+        // Reconfiguration thread: swap rings again as soon as the last swap is reclaimed
+        int numHandovers = 0;
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        while (framesRead.load() < numFrames && !stop.load())
+        {
+            if (juce::Time::getMillisecondCounterHiRes() - startTime > timeoutMs)
+            {
+                stop.store(true);
+                break;
+            }
+
+            if (device.handoverFrom == nullptr)
+            {
+                device.requestedBufferSize.store(periods[(numHandovers + 1) % 2]);
+                device.applyRequestedFormat();
+
+                if (device.handoverFrom != nullptr)
+                    ++numHandovers;
+            }
+
+            device.reclaimRetiredRing();
+            std::this_thread::yield();
+        }
+
+        producer.join();
+        reader.join();
+        logMessage(juce::String(numHandovers) + " handovers");
+
+        expectEquals(firstWrongFrame, -1, "Frame " + juce::String(firstWrongFrame) + " is missing or out of order");
+        expectEquals(framesRead.load(), numFrames, "Stopped after " + juce::String(framesRead.load()) + " frames");
+        expectEquals(static_cast<int>(device.getOverrunCount()), 0, "Overruns");
+        expectGreaterThan(numHandovers, 100, "Too few handovers to stress the swap");
+
+        device.active.store(false);
+        device.initialized.store(false);
+    }
+};
+
+static RingHandoverTests ringHandoverTests;
+#endif
+
+//==============================================================================
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: AudioProcessorTests [--source-dir <repository>] [--category Golden|Consistency|Handover] [--update-golden]\n"
+                  << "  --source-dir     where the .preset files and TestData/golden live (default: current directory)\n"
+                  << "  --category       run one category only (default: all)\n"
+                  << "  --update-golden  rewrite the golden references from this build instead of comparing\n"
+                  << "  Exits with " << skipReturnCode << " (skipped) when golden references are missing.\n";
+    }
 }
 
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    const auto sourceDirectoryText = args.removeValueForOption("--source-dir");
+    const auto category = args.removeValueForOption("--category");
+    options.updateGolden = args.removeOptionIfFound("--update-golden");
+    options.sourceDirectory = sourceDirectoryText.isNotEmpty()
+                                  ? juce::File::getCurrentWorkingDirectory().getChildFile(sourceDirectoryText.unquoted())
+                                  : juce::File::getCurrentWorkingDirectory();
+
+    if (!getPresetFile(presetNames[0]).existsAsFile())
+    {
+        std::cerr << "No presets in " << options.sourceDirectory.getFullPathName() << "; pass --source-dir\n";
+        return 1;
+    }
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (category.isNotEmpty())
+        runner.runTestsInCategory(category);
+    else
+        runner.runAllTests();
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    getScratchDirectory().deleteRecursively();
+
+    if (numFailures > 0)
+    {
+        std::cerr << numFailures << " failure(s)\n";
+        return 1;
+    }
+
+    if (numMissingReferences > 0)
+    {
+        std::cerr << numMissingReferences << " golden reference(s) missing in " << getGoldenDirectory().getFullPathName()
+                  << "; generate them on a reference build with --update-golden and commit them\n";
+        return skipReturnCode;
+    }
+
+    return 0;
+}